@@ -0,0 +1,91 @@
+#ifndef CODEGENERATOR_RUNTIME_ENUM_HPP
+#define CODEGENERATOR_RUNTIME_ENUM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace CodeGenerator {
+    template<typename E>
+    struct EnumEntry {
+        std::string_view name;
+        E value;
+    };
+
+    /// \brief specialized by the generated .gen.hpp files for every CGENUM
+    /// \note a specialization has a name, the entries sorted by name, and a value to name table:
+    /// \note dense enums have names, indexed by the value minus minimum, sparse enums have byValue, sorted by value
+    template<typename E>
+    struct EnumReflection;
+
+    /// \brief the value as a signed 64-bit integer, the same way the generator stores it
+    template<typename E>
+    constexpr int64_t ToInteger(E value) {
+        return static_cast<int64_t>(static_cast<std::underlying_type_t<E>>(value));
+    }
+
+    /// \brief returns the enumerators of E sorted by name
+    template<typename E>
+    constexpr const auto &GetEnumEntries() {
+        return EnumReflection<E>::entries;
+    }
+
+    /// \brief returns the name of the value, or an empty string if the value has no enumerator
+    /// \note a table lookup for dense enums, a binary search for sparse ones, aliases return the first enumerator
+    template<typename E>
+    constexpr std::string_view EnumToString(E value) {
+        using Table = EnumReflection<E>;
+        const auto integer = ToInteger(value);
+
+        if constexpr (Table::dense) {
+            //compared as unsigned, so values below the minimum wrap around and fail the size check as well
+            const auto index = static_cast<uint64_t>(integer) - static_cast<uint64_t>(Table::minimum);
+            return index < Table::names.size() ? Table::names[index] : std::string_view{};
+        } else {
+            size_t first = 0;
+            size_t count = Table::byValue.size();
+            while (count > 0) {
+                const auto half = count / 2;
+                if (ToInteger(Table::byValue[first + half].value) < integer) {
+                    first += half + 1;
+                    count -= half + 1;
+                } else {
+                    count = half;
+                }
+            }
+
+            if (first < Table::byValue.size() && ToInteger(Table::byValue[first].value) == integer) {
+                return Table::byValue[first].name;
+            }
+            return {};
+        }
+    }
+
+    /// \brief returns the value of the enumerator with the name, or nullopt if E has no such enumerator
+    template<typename E>
+    constexpr std::optional<E> EnumFromString(std::string_view name) {
+        const auto &entries = GetEnumEntries<E>();
+
+        size_t first = 0;
+        size_t count = entries.size();
+        while (count > 0) {
+            const auto half = count / 2;
+            if (entries[first + half].name < name) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+
+        if (first < entries.size() && entries[first].name == name) {
+            return entries[first].value;
+        }
+        return std::nullopt;
+    }
+}
+
+#endif //CODEGENERATOR_RUNTIME_ENUM_HPP
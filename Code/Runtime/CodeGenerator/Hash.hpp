@@ -0,0 +1,134 @@
+#ifndef CODEGENERATOR_RUNTIME_HASH_HPP
+#define CODEGENERATOR_RUNTIME_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+namespace CodeGenerator {
+    /// \brief specialized by the generated .gen.hpp files for every CGCLASS with the Hashable property
+    /// \note a specialization has a static uint64_t Hash(const T &)
+    template<typename T>
+    struct Hasher;
+
+    template<typename T, typename = void>
+    struct HasHasher : std::false_type {
+    };
+
+    template<typename T>
+    struct HasHasher<T, std::void_t<decltype(Hasher<T>::Hash(std::declval<const T &>()))>> : std::true_type {
+    };
+
+    namespace Detail {
+        inline uint64_t Mix(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        inline uint64_t Load(const unsigned char *bytes, size_t size) {
+            uint64_t value = 0;
+            std::memcpy(&value, bytes, size);
+            return value;
+        }
+
+        template<typename T, typename = void>
+        struct IsContiguousRange : std::false_type {
+        };
+
+        //strings and vectors, std::vector<bool> has no data() and is hashed with std::hash instead
+        template<typename T>
+        struct IsContiguousRange<T, std::void_t<decltype(std::declval<const T &>().data()),
+                decltype(std::declval<const T &>().size()), typename T::value_type>> : std::true_type {
+        };
+    }
+
+    /// \brief combines two hashes, the result depends on the order of the hashes
+    inline uint64_t CombineHashes(uint64_t seed, uint64_t hash) {
+        return seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    /// \brief a fast non-cryptographic hash of the bytes, reading 8 bytes at a time
+    inline uint64_t HashBytes(const void *data, size_t size, uint64_t seed = 0) {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        uint64_t hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+
+        for (; size >= 8; bytes += 8, size -= 8) {
+            hash = Detail::Mix(hash ^ Detail::Load(bytes, 8));
+        }
+        if (size > 0) {
+            hash = Detail::Mix(hash ^ Detail::Load(bytes, size));
+        }
+        return Detail::Mix(hash);
+    }
+
+    /// \brief true when comparing and hashing the bytes of the members gives the same result as comparing the members
+    /// \note the members must have no padding in between, so the span of the run is the sum of their sizes
+    /// \note Hashable members are compared and hashed by their generated code, which only looks at annotated members
+    template<typename... Members>
+    constexpr bool IsPackedRun(size_t span) {
+        return ((std::has_unique_object_representations_v<Members> && !HasHasher<Members>::value) && ...) &&
+               span == (sizeof(Members) + ...);
+    }
+
+    /// \brief hashes the value, using the generated Hasher for Hashable classes
+    /// \note values without padding are hashed as bytes, floats so that 0.0 and -0.0 have the same hash,
+    /// \note strings, vectors, and arrays element by element unless their elements are bytes as well
+    template<typename T>
+    uint64_t Hash(const T &value) {
+        if constexpr (HasHasher<T>::value) {
+            return Hasher<T>::Hash(value);
+        } else if constexpr (std::is_array_v<T>) {
+            using Element = std::remove_extent_t<T>;
+            if constexpr (std::has_unique_object_representations_v<Element> && !HasHasher<Element>::value) {
+                return HashBytes(value, sizeof(T));
+            } else {
+                uint64_t hash = 0;
+                for (const auto &element: value) {
+                    hash = CombineHashes(hash, Hash(element));
+                }
+                return hash;
+            }
+        } else if constexpr (std::has_unique_object_representations_v<T>) {
+            return HashBytes(&value, sizeof(T));
+        } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            const T normalized = value == T{} ? T{} : value;
+            return HashBytes(&normalized, sizeof(T));
+        } else if constexpr (Detail::IsContiguousRange<T>::value) {
+            using Element = typename T::value_type;
+            if constexpr (std::has_unique_object_representations_v<Element> && !HasHasher<Element>::value) {
+                return HashBytes(value.data(), value.size() * sizeof(Element));
+            } else {
+                uint64_t hash = value.size();
+                for (const auto &element: value) {
+                    hash = CombineHashes(hash, Hash(element));
+                }
+                return hash;
+            }
+        } else {
+            return std::hash<T>{}(value);
+        }
+    }
+
+    /// \brief compares the values, arrays element by element
+    template<typename T>
+    bool Equal(const T &a, const T &b) {
+        if constexpr (std::is_array_v<T>) {
+            for (size_t i = 0; i < std::extent_v<T>; ++i) {
+                if (!Equal(a[i], b[i])) {
+                    return false;
+                }
+            }
+            return true;
+        } else {
+            return a == b;
+        }
+    }
+}
+
+#endif //CODEGENERATOR_RUNTIME_HASH_HPP
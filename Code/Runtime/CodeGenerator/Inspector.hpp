@@ -0,0 +1,84 @@
+#ifndef CODEGENERATOR_RUNTIME_INSPECTOR_HPP
+#define CODEGENERATOR_RUNTIME_INSPECTOR_HPP
+
+#include "Reflection.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace CodeGenerator {
+    /// \brief specialized by the generated .gen.hpp files for every LuaClass with LuaInspect members
+    /// \note a specialization has the seeds and the names of a minimal perfect hash of the member names,
+    /// \note and Visit(object, slot, function), a switch calling the function with the member in the slot
+    template<typename T>
+    struct Inspector;
+
+    /// \brief the slot of a name in a table of count names, given the hash of the name and the seed of its bucket
+    /// \note the code generator searches the seeds with this function, so it has to stay in sync with the tables
+    constexpr size_t GetPerfectHashSlot(uint64_t hash, uint64_t seed, size_t count) {
+        hash ^= seed * 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        return static_cast<size_t>(hash % count);
+    }
+
+    /// \brief the bucket of a name, every bucket has its own seed
+    constexpr size_t GetPerfectHashBucket(uint64_t hash, size_t bucketCount) {
+        return static_cast<size_t>(hash % bucketCount);
+    }
+
+    /// \brief returns the slot of the inspected member with the name, or the amount of members if T has no such member
+    /// \note one hash of the name, and one comparison to verify it
+    template<typename T>
+    constexpr size_t FindMemberSlot(std::string_view name) {
+        using Table = Inspector<T>;
+        const auto hash = Fnv1a(name);
+        const auto seed = Table::seeds[GetPerfectHashBucket(hash, Table::seeds.size())];
+        const auto slot = GetPerfectHashSlot(hash, seed, Table::names.size());
+        return Table::names[slot] == name ? slot : Table::names.size();
+    }
+
+    /// \brief assigns the value to the inspected member with the name
+    /// \return false if T has no such member, or the value doesn't convert to its type
+    template<typename T, typename Value>
+    bool SetByName(T &object, std::string_view name, const Value &value) {
+        const auto slot = FindMemberSlot<T>(name);
+        if (slot == Inspector<T>::names.size()) {
+            return false;
+        }
+        return Inspector<T>::Visit(object, slot, [&value](auto &member) {
+            //convertible as well, so a number isn't assigned to a string as a character
+            using Member = std::remove_reference_t<decltype(member)>;
+            if constexpr (std::is_convertible_v<const Value &, Member> && std::is_assignable_v<Member &, const Value &>) {
+                member = value;
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+
+    /// \brief assigns the inspected member with the name to the value
+    /// \return false if T has no such member, or its type doesn't convert to the type of the value
+    template<typename T, typename Value>
+    bool GetByName(const T &object, std::string_view name, Value &value) {
+        const auto slot = FindMemberSlot<T>(name);
+        if (slot == Inspector<T>::names.size()) {
+            return false;
+        }
+        return Inspector<T>::Visit(object, slot, [&value](const auto &member) {
+            if constexpr (std::is_convertible_v<decltype(member), Value> && std::is_assignable_v<Value &, decltype(member)>) {
+                value = member;
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+}
+
+#endif //CODEGENERATOR_RUNTIME_INSPECTOR_HPP
@@ -0,0 +1,96 @@
+#ifndef CODEGENERATOR_RUNTIME_REFLECTION_HPP
+#define CODEGENERATOR_RUNTIME_REFLECTION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// \brief the part of the code generator that is compiled into the project using the generated files
+namespace CodeGenerator {
+    using TypeId = uint64_t;
+
+    /// \brief 64-bit FNV-1a hash of the text, usable in constant expressions
+    constexpr uint64_t Fnv1a(std::string_view text) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (const char c: text) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /// \brief returns an id of the type that is the same in every translation unit of a build
+    /// \note the id is a hash of the signature of this function, it may differ between compilers
+    template<typename T>
+    constexpr TypeId GetTypeId() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return Fnv1a(__FUNCSIG__);
+#else
+        return Fnv1a(__PRETTY_FUNCTION__);
+#endif
+    }
+
+    /// \brief describes a member variable of a reflected class
+    struct FieldDescriptor {
+        std::string_view name;
+        //the type as written in the source
+        std::string_view typeName;
+        size_t offset;
+        size_t size;
+        size_t alignment;
+        TypeId typeId;
+    };
+
+    /// \brief specialized by the generated .gen.hpp files for every CGCLASS
+    /// \note a specialization has a name and a constexpr std::array<FieldDescriptor, N> fields
+    template<typename T>
+    struct Reflection;
+
+    /// \brief returns the descriptors of the annotated members of T, in declaration order
+    /// \note include the .gen.hpp of the class to use this
+    template<typename T>
+    constexpr const auto &Reflect() {
+        return Reflection<T>::fields;
+    }
+
+    /// \brief returns the descriptor of the field with the name, or nullptr if T has no such field
+    template<typename T>
+    constexpr const FieldDescriptor *FindField(std::string_view name) {
+        for (const auto &field: Reflect<T>()) {
+            if (field.name == name) {
+                return &field;
+            }
+        }
+        return nullptr;
+    }
+
+    /// \brief returns a pointer to the field of the object, or nullptr if the field is not a Field
+    template<typename Field, typename T>
+    Field *GetField(T &object, const FieldDescriptor &field) {
+        if (field.typeId != GetTypeId<Field>()) {
+            return nullptr;
+        }
+        return reinterpret_cast<Field *>(reinterpret_cast<std::byte *>(&object) + field.offset);
+    }
+
+    template<typename Field, typename T>
+    const Field *GetField(const T &object, const FieldDescriptor &field) {
+        if (field.typeId != GetTypeId<Field>()) {
+            return nullptr;
+        }
+        return reinterpret_cast<const Field *>(reinterpret_cast<const std::byte *>(&object) + field.offset);
+    }
+
+    /// \brief calls the function with the descriptor and the address of every field of the object
+    /// \param function called as function(const FieldDescriptor &, void *) for every field
+    template<typename T, typename Function>
+    void ForEachField(T &object, Function &&function) {
+        auto *base = reinterpret_cast<std::byte *>(&object);
+        for (const auto &field: Reflect<T>()) {
+            function(field, static_cast<void *>(base + field.offset));
+        }
+    }
+}
+
+#endif //CODEGENERATOR_RUNTIME_REFLECTION_HPP
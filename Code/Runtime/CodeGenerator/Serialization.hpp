@@ -0,0 +1,204 @@
+#ifndef CODEGENERATOR_RUNTIME_SERIALIZATION_HPP
+#define CODEGENERATOR_RUNTIME_SERIALIZATION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CodeGenerator {
+    /// \brief bytes written by Write, the layout is the memory layout of the build that wrote them
+    /// \note meant for save games and snapshots read by the same build, not as an exchange format
+    class Buffer {
+        std::vector<std::byte> data;
+    public:
+        /// \brief makes room for at least size more bytes, growing geometrically
+        void Grow(size_t size) {
+            const auto required = data.size() + size;
+            if (required > data.capacity()) {
+                data.reserve(std::max(required, data.capacity() * 2));
+            }
+        };
+
+        void WriteBytes(const void *bytes, size_t size) {
+            const auto offset = data.size();
+            data.resize(offset + size);
+            std::memcpy(data.data() + offset, bytes, size);
+        };
+
+        void Clear() {
+            data.clear();
+        };
+
+        [[nodiscard]] const std::byte *GetData() const {
+            return data.data();
+        };
+
+        [[nodiscard]] size_t GetSize() const {
+            return data.size();
+        };
+    };
+
+    /// \brief reads the bytes of a Buffer back, every read fails once the end is reached
+    class Reader {
+        const std::byte *data;
+        size_t size;
+        size_t position = 0;
+    public:
+        Reader(const std::byte *data, size_t size) : data(data), size(size) {};
+
+        explicit Reader(const Buffer &buffer) : Reader(buffer.GetData(), buffer.GetSize()) {};
+
+        bool ReadBytes(void *bytes, size_t count) {
+            if (count > size - position) {
+                return false;
+            }
+            std::memcpy(bytes, data + position, count);
+            position += count;
+            return true;
+        };
+
+        [[nodiscard]] size_t GetPosition() const {
+            return position;
+        };
+
+        [[nodiscard]] size_t GetRemaining() const {
+            return size - position;
+        };
+    };
+
+    /// \brief specialized by the generated .gen.hpp files for every CGCLASS with the Serialize property
+    /// \note a specialization has a fixedSize, and static Write(Buffer &, const T &) and Read(Reader &, T &)
+    template<typename T>
+    struct Serializer;
+
+    template<typename T, typename = void>
+    struct HasSerializer : std::false_type {
+    };
+
+    template<typename T>
+    struct HasSerializer<T, std::void_t<decltype(Serializer<T>::fixedSize)>> : std::true_type {
+    };
+
+    /// \brief upper bound of the bytes written for T, not counting the contents of strings and vectors
+    template<typename T>
+    constexpr size_t GetFixedSize() {
+        if constexpr (HasSerializer<T>::value) {
+            return Serializer<T>::fixedSize;
+        } else if constexpr (std::is_trivially_copyable_v<T>) {
+            return sizeof(T);
+        } else {
+            //strings and vectors write their length in front of their contents
+            return sizeof(uint64_t);
+        }
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_trivially_copyable_v<T> && !HasSerializer<T>::value> Write(Buffer &buffer, const T &value) {
+        buffer.WriteBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_trivially_copyable_v<T> && !HasSerializer<T>::value, bool> Read(Reader &reader, T &value) {
+        return reader.ReadBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    std::enable_if_t<HasSerializer<T>::value> Write(Buffer &buffer, const T &value) {
+        Serializer<T>::Write(buffer, value);
+    }
+
+    template<typename T>
+    std::enable_if_t<HasSerializer<T>::value, bool> Read(Reader &reader, T &value) {
+        return Serializer<T>::Read(reader, value);
+    }
+
+    inline void Write(Buffer &buffer, const std::string &value) {
+        const uint64_t size = value.size();
+        buffer.Grow(sizeof(size) + value.size());
+        buffer.WriteBytes(&size, sizeof(size));
+        buffer.WriteBytes(value.data(), value.size());
+    }
+
+    inline bool Read(Reader &reader, std::string &value) {
+        uint64_t size = 0;
+        if (!reader.ReadBytes(&size, sizeof(size))) {
+            return false;
+        }
+        //a corrupt size fails here instead of allocating
+        if (size > reader.GetRemaining()) {
+            return false;
+        }
+        value.resize(static_cast<size_t>(size));
+        return reader.ReadBytes(value.data(), value.size());
+    }
+
+    //vectors of these are written with a single copy, std::vector<bool> has no data() to copy from
+    template<typename T>
+    constexpr bool IsBulkCopyable = std::is_trivially_copyable_v<T> && !HasSerializer<T>::value && !std::is_same_v<T, bool>;
+
+    template<typename T, typename Allocator>
+    void Write(Buffer &buffer, const std::vector<T, Allocator> &values) {
+        const uint64_t size = values.size();
+        buffer.WriteBytes(&size, sizeof(size));
+
+        if constexpr (IsBulkCopyable<T>) {
+            buffer.WriteBytes(values.data(), values.size() * sizeof(T));
+        } else {
+            buffer.Grow(values.size() * GetFixedSize<T>());
+            for (const auto &value: values) {
+                Write(buffer, value);
+            }
+        }
+    }
+
+    template<typename T, typename Allocator>
+    bool Read(Reader &reader, std::vector<T, Allocator> &values) {
+        uint64_t size = 0;
+        if (!reader.ReadBytes(&size, sizeof(size))) {
+            return false;
+        }
+
+        if constexpr (IsBulkCopyable<T>) {
+            if (size > reader.GetRemaining() / sizeof(T)) {
+                return false;
+            }
+            values.resize(static_cast<size_t>(size));
+            return reader.ReadBytes(values.data(), values.size() * sizeof(T));
+        } else {
+            //read into a local, the elements of std::vector<bool> can't be bound to a reference
+            values.clear();
+            for (uint64_t i = 0; i < size; ++i) {
+                T value{};
+                if (!Read(reader, value)) {
+                    return false;
+                }
+                values.emplace_back(std::move(value));
+            }
+            return true;
+        }
+    }
+
+    template<typename T, size_t N>
+    std::enable_if_t<!std::is_trivially_copyable_v<T>> Write(Buffer &buffer, const T (&values)[N]) {
+        for (const auto &value: values) {
+            Write(buffer, value);
+        }
+    }
+
+    template<typename T, size_t N>
+    std::enable_if_t<!std::is_trivially_copyable_v<T>, bool> Read(Reader &reader, T (&values)[N]) {
+        for (auto &value: values) {
+            if (!Read(reader, value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+#endif //CODEGENERATOR_RUNTIME_SERIALIZATION_HPP
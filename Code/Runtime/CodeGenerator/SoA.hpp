@@ -0,0 +1,272 @@
+#ifndef CODEGENERATOR_RUNTIME_SOA_HPP
+#define CODEGENERATOR_RUNTIME_SOA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CodeGenerator {
+    /// \brief the alignment of every column, a cache line, so loops over a column can use aligned vector loads
+    inline constexpr size_t columnAlignment = 64;
+
+    /// \brief a growable array aligned to columnAlignment, holding one member of every element of a SoA container
+    /// \note unlike std::vector, a column of bool stores one bool per element, so references to elements are plain
+    template<typename T>
+    class Column {
+        static constexpr std::align_val_t alignment{std::max(columnAlignment, alignof(T))};
+
+        T *data = nullptr;
+        size_t size = 0;
+        size_t capacity = 0;
+
+        static T *Allocate(size_t count) {
+            return static_cast<T *>(::operator new(count * sizeof(T), alignment));
+        }
+
+        static void Deallocate(T *pointer) {
+            ::operator delete(pointer, alignment);
+        }
+
+        void Grow() {
+            Reserve(capacity == 0 ? 8 : capacity * 2);
+        }
+    public:
+        Column() = default;
+
+        Column(const Column &other) {
+            Reserve(other.size);
+            try {
+                std::uninitialized_copy(other.data, other.data + other.size, data);
+            } catch (...) {
+                Deallocate(data);
+                throw;
+            }
+            size = other.size;
+        };
+
+        Column(Column &&other) noexcept :
+            data(std::exchange(other.data, nullptr)),
+            size(std::exchange(other.size, 0)),
+            capacity(std::exchange(other.capacity, 0)) {};
+
+        Column &operator=(Column other) noexcept {
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+            std::swap(capacity, other.capacity);
+            return *this;
+        };
+
+        ~Column() {
+            Clear();
+            Deallocate(data);
+        };
+
+        /// \brief makes room for at least capacity elements, moving the elements to a new array if needed
+        void Reserve(size_t newCapacity) {
+            if (newCapacity <= capacity) {
+                return;
+            }
+
+            //elements are copied if moving them could throw, so a failed Reserve leaves the column unchanged
+            auto *newData = Allocate(newCapacity);
+            try {
+                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+                    std::uninitialized_move(data, data + size, newData);
+                } else {
+                    std::uninitialized_copy(data, data + size, newData);
+                }
+            } catch (...) {
+                Deallocate(newData);
+                throw;
+            }
+            std::destroy(data, data + size);
+            Deallocate(data);
+            data = newData;
+            capacity = newCapacity;
+        };
+
+        template<typename... Arguments>
+        T &EmplaceBack(Arguments &&... arguments) {
+            if (size == capacity) {
+                Grow();
+            }
+            auto *element = ::new(static_cast<void *>(data + size)) T(std::forward<Arguments>(arguments)...);
+            ++size;
+            return *element;
+        };
+
+        /// \brief removes the element, moving the elements after it forward to keep the order
+        void Erase(size_t index) {
+            std::move(data + index + 1, data + size, data + index);
+            std::destroy_at(data + size - 1);
+            --size;
+        };
+
+        /// \brief removes the elements from the index on, does nothing if the column is not larger than newSize
+        void Truncate(size_t newSize) {
+            if (newSize < size) {
+                std::destroy(data + newSize, data + size);
+                size = newSize;
+            }
+        };
+
+        void Clear() {
+            Truncate(0);
+        };
+
+        [[nodiscard]] T *Data() {
+            return data;
+        };
+
+        [[nodiscard]] const T *Data() const {
+            return data;
+        };
+
+        [[nodiscard]] size_t Size() const {
+            return size;
+        };
+
+        [[nodiscard]] size_t Capacity() const {
+            return capacity;
+        };
+
+        T &operator[](size_t index) {
+            return data[index];
+        };
+
+        const T &operator[](size_t index) const {
+            return data[index];
+        };
+
+        T *begin() {
+            return data;
+        };
+
+        T *end() {
+            return data + size;
+        };
+
+        const T *begin() const {
+            return data;
+        };
+
+        const T *end() const {
+            return data + size;
+        };
+    };
+
+    /// \brief specialized by the generated .gen.hpp files for every CGCLASS with the SoA property
+    /// \note a specialization has a Column for every annotated member, named like the member,
+    /// \note Reference and ConstReference proxies with a reference to every member of an element,
+    /// \note and Size, Reserve, PushBack, Erase, Clear, operator[], begin and end
+    template<typename T>
+    class SoA;
+
+    /// \brief iterates the elements of a SoA container, dereferencing returns a proxy reference by value
+    /// \note assigning and swapping proxies moves the values, so algorithms like std::sort work on the container
+    template<typename Container, typename Reference>
+    class SoAIterator {
+        Container *container = nullptr;
+        size_t index = 0;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename std::remove_const_t<Container>::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = Reference;
+        using pointer = void;
+
+        SoAIterator() = default;
+
+        SoAIterator(Container *container, size_t index) : container(container), index(index) {};
+
+        Reference operator*() const {
+            return (*container)[index];
+        };
+
+        Reference operator[](difference_type offset) const {
+            return (*container)[index + offset];
+        };
+
+        SoAIterator &operator++() {
+            ++index;
+            return *this;
+        };
+
+        SoAIterator operator++(int) {
+            auto previous = *this;
+            ++index;
+            return previous;
+        };
+
+        SoAIterator &operator--() {
+            --index;
+            return *this;
+        };
+
+        SoAIterator operator--(int) {
+            auto previous = *this;
+            --index;
+            return previous;
+        };
+
+        SoAIterator &operator+=(difference_type offset) {
+            index += offset;
+            return *this;
+        };
+
+        SoAIterator &operator-=(difference_type offset) {
+            index -= offset;
+            return *this;
+        };
+
+        SoAIterator operator+(difference_type offset) const {
+            return {container, index + offset};
+        };
+
+        friend SoAIterator operator+(difference_type offset, const SoAIterator &iterator) {
+            return iterator + offset;
+        };
+
+        SoAIterator operator-(difference_type offset) const {
+            return {container, index - offset};
+        };
+
+        difference_type operator-(const SoAIterator &other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        };
+
+        [[nodiscard]] size_t GetIndex() const {
+            return index;
+        };
+
+        bool operator==(const SoAIterator &other) const {
+            return index == other.index && container == other.container;
+        };
+
+        bool operator!=(const SoAIterator &other) const {
+            return !(*this == other);
+        };
+
+        bool operator<(const SoAIterator &other) const {
+            return index < other.index;
+        };
+
+        bool operator>(const SoAIterator &other) const {
+            return index > other.index;
+        };
+
+        bool operator<=(const SoAIterator &other) const {
+            return index <= other.index;
+        };
+
+        bool operator>=(const SoAIterator &other) const {
+            return index >= other.index;
+        };
+    };
+}
+
+#endif //CODEGENERATOR_RUNTIME_SOA_HPP
@@ -0,0 +1,273 @@
+#include "PropertyBench.hpp"
+#include "SerializationBench.hpp"
+#include "SyntheticProject.hpp"
+
+#include "FileGenerator.hpp"
+#include "FileParser.hpp"
+#include "Pipeline.hpp"
+#include "SimpleOptionParser.hpp"
+#include "Statistics.hpp"
+#include "XmlParser.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct BenchOptions {
+        SyntheticProjectOptions project;
+        //options of the pipeline, only the ones that don't persist between runs are supported
+        Options pipeline;
+        //measured runs, the median and minimum are reported
+        size_t iterations = 5;
+        //runs before the measured runs, these warm up the file system cache
+        size_t warmup = 1;
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "CodeGeneratorBench";
+        //keep the output of the pipeline, it is silenced by default so printing doesn't dominate the results
+        bool verbose = false;
+    };
+
+    struct Sample {
+        Statistics::Duration load;
+        Statistics::Duration extract;
+        Statistics::Duration parse;
+        Statistics::Duration traverse;
+        Statistics::Duration generate;
+        Statistics::Duration write;
+        Statistics::Duration total;
+        Statistics::Counters counters;
+    };
+
+    /// \brief discards everything written to std::cout while alive
+    class SilenceOutput {
+        std::streambuf *previous = nullptr;
+    public:
+        explicit SilenceOutput(bool enabled) {
+            if (enabled) {
+                previous = std::cout.rdbuf(nullptr);
+            }
+        };
+
+        ~SilenceOutput() {
+            if (previous != nullptr) {
+                std::cout.rdbuf(previous);
+                std::cout.clear();
+            }
+        };
+    };
+
+    bool ParseSize(const char *text, size_t &value) {
+        try {
+            value = std::stoul(text);
+            return true;
+        } catch (const std::exception &) {
+            std::cerr << "Error: " << text << " is not a valid number" << std::endl;
+            return false;
+        }
+    }
+
+    bool ParseArguments(int argc, char *argv[], BenchOptions &options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument{argv[i]};
+            const bool hasValue = i + 1 < argc;
+            bool valid = true;
+
+            if (argument == "--headers" && hasValue) {
+                valid = ParseSize(argv[++i], options.project.headers);
+            } else if (argument == "--classes" && hasValue) {
+                valid = ParseSize(argv[++i], options.project.classesPerHeader);
+            } else if (argument == "--members" && hasValue) {
+                valid = ParseSize(argv[++i], options.project.annotatedMembers);
+            } else if (argument == "--depth" && hasValue) {
+                valid = ParseSize(argv[++i], options.project.includeDepth);
+            } else if (argument == "--comments" && hasValue) {
+                valid = ParseSize(argv[++i], options.project.commentLines);
+            } else if (argument == "--attributes") {
+                options.project.attributes = true;
+            } else if (argument == "--large-header") {
+                //a single header of about 10k lines with 2k annotated members, stresses the per decl source lookups
+                options.project.headers = 1;
+                options.project.classesPerHeader = 1;
+                options.project.annotatedMembers = 2000;
+                options.project.commentLines = 2;
+                options.project.includeDepth = 0;
+            } else if (argument == "--iterations" && hasValue) {
+                valid = ParseSize(argv[++i], options.iterations);
+            } else if (argument == "--warmup" && hasValue) {
+                valid = ParseSize(argv[++i], options.warmup);
+            } else if ((argument == "--jobs" || argument == "-j") && hasValue) {
+                size_t jobs = 0;
+                valid = ParseSize(argv[++i], jobs);
+                options.pipeline.jobs = static_cast<unsigned>(jobs);
+            } else if (argument == "--directory" && hasValue) {
+                options.directory = argv[++i];
+            } else if (argument == "--unity") {
+                options.pipeline.unity = true;
+            } else if (argument == "--sources") {
+                options.pipeline.sources = true;
+            } else if (argument == "--no-prescan") {
+                options.pipeline.prescan = false;
+            } else if (argument == "--fast-traversal") {
+                options.pipeline.fastTraversal = true;
+            } else if (argument == "--verbose") {
+                options.verbose = true;
+            } else {
+                std::cerr << "Error: unknown argument " << argument << std::endl;
+                valid = false;
+            }
+
+            if (!valid) {
+                return false;
+            }
+        }
+
+        if (options.iterations == 0) {
+            std::cerr << "Error: at least one iteration is required" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /// \brief runs the whole pipeline once, the same way the CodeGenerator executable does without a cache
+    Sample Run(const BenchOptions &options, const std::filesystem::path &project, const std::filesystem::path &output) {
+        SilenceOutput silence{!options.verbose};
+
+        Statistics::Reset();
+        ASTFileParser::ClearParsers();
+
+        const auto start = Statistics::Clock::now();
+
+        std::vector<std::filesystem::path> headers{};
+        std::vector<std::filesystem::path> sources{};
+        std::filesystem::path root{};
+        {
+            Statistics::ScopedTimer timer{Statistics::Phase::LoadProject};
+            const XmlParser xmlParser{project};
+            headers = xmlParser.GetAllHeaders();
+            if (options.pipeline.sources) {
+                sources = xmlParser.GetAllSources();
+            }
+            root = xmlParser.GetDirectoryRoot();
+        }
+
+        SimpleOptionParser optionParser{Pipeline::GetCompileArguments(), headers};
+        optionParser.SetOutputDirectory(output);
+        optionParser.SetInputDirectory(root);
+
+        ASTFileParser::SetProjectHeaders(headers);
+        ASTFileParser::SetFastTraversal(options.pipeline.fastTraversal);
+        FileGenerator::output_directory = output;
+
+        const auto extractStart = Statistics::Clock::now();
+        Pipeline::ExtractHeaders(options.pipeline, optionParser, headers, output, sources);
+        const auto extract = Statistics::Clock::now() - extractStart;
+
+        Pipeline::GenerateFiles(options.pipeline, headers);
+
+        Sample sample{};
+        sample.total = Statistics::Clock::now() - start;
+        sample.load = Statistics::GetTime(Statistics::Phase::LoadProject);
+        sample.extract = extract;
+        sample.parse = Statistics::GetTime(Statistics::Phase::Parse);
+        sample.traverse = Statistics::GetTime(Statistics::Phase::Traverse);
+        sample.generate = Statistics::GetTime(Statistics::Phase::Generate);
+        sample.write = Statistics::GetTime(Statistics::Phase::Write);
+        sample.counters = Statistics::GetCounters();
+        return sample;
+    }
+
+    double ToSeconds(Statistics::Duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    /// \brief prints the median and minimum of a stage, and the throughput based on the median
+    void PrintStage(const std::string &name, std::vector<Statistics::Duration> durations, size_t headers,
+                    uint64_t decls) {
+        std::sort(durations.begin(), durations.end());
+        const auto median = ToSeconds(durations[durations.size() / 2]);
+        const auto minimum = ToSeconds(durations.front());
+
+        std::cout << std::left << std::setw(16) << name << std::right
+                  << std::setw(12) << median * 1000.0
+                  << std::setw(12) << minimum * 1000.0
+                  << std::setw(14) << (median > 0.0 ? static_cast<double>(headers) / median : 0.0)
+                  << std::setw(14) << (median > 0.0 ? static_cast<double>(decls) / median : 0.0) << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    //microbenchmarks are selected by name, without a name the whole pipeline is benchmarked
+    if (argc > 1 && std::string{argv[1]} == "properties") {
+        return RunPropertyBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::string{argv[1]} == "serialize") {
+        return RunSerializationBenchmark(argc - 1, argv + 1);
+    }
+
+    BenchOptions options{};
+    if (!ParseArguments(argc, argv, options)) {
+        std::cout << "Usage: " << argv[0] << " properties [--iterations N]" << std::endl;
+        std::cout << "       " << argv[0] << " serialize [--iterations N] [--objects N]" << std::endl;
+        std::cout << "       " << argv[0] << " [--headers N] [--classes N] [--members N] [--depth N] [--comments N] [--attributes] [--large-header]"
+                  << " [--iterations N] [--warmup N] [--jobs N] [--unity] [--sources] [--no-prescan] [--fast-traversal]"
+                  << " [--directory <dir>] [--verbose]" << std::endl;
+        return 1;
+    }
+
+    const auto project = SyntheticProject::Generate(options.directory, options.project);
+    const auto output = options.directory / "Generated";
+    std::filesystem::create_directories(output);
+
+    for (size_t i = 0; i < options.warmup; ++i) {
+        Run(options, project, output);
+    }
+
+    std::vector<Sample> samples{};
+    for (size_t i = 0; i < options.iterations; ++i) {
+        samples.emplace_back(Run(options, project, output));
+    }
+
+    const auto counters = samples.front().counters;
+    const auto headers = options.project.headers;
+
+    std::cout << "Project: " << headers << " headers, " << options.project.classesPerHeader << " classes per header, "
+              << options.project.annotatedMembers << " annotated members per class, include depth "
+              << options.project.includeDepth << ", " << options.project.commentLines << " comment lines per member"
+              << std::endl;
+    std::cout << "Runs: " << options.iterations << " (" << options.warmup << " warmup), jobs "
+              << options.pipeline.jobs << (options.pipeline.unity ? ", unity" : "")
+              << (options.pipeline.sources ? ", sources" : "")
+              << (options.pipeline.fastTraversal ? ", fast traversal" : "")
+              << (options.pipeline.prescan ? "" : ", no prescan") << std::endl;
+    std::cout << "Decls visited: " << counters.declsVisited << ", annotated entities: " << counters.annotatedEntities
+              << " (expected " << SyntheticProject::GetAnnotatedCount(options.project) << ")" << std::endl;
+    std::cout << std::endl;
+
+    const auto flags = std::cout.flags();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Stage             Median (ms)    Min (ms)     Headers/s       Decls/s" << std::endl;
+
+    const auto stage = [&samples](Statistics::Duration Sample::*member) {
+        std::vector<Statistics::Duration> durations{};
+        for (const auto &sample: samples) {
+            durations.emplace_back(sample.*member);
+        }
+        return durations;
+    };
+
+    PrintStage("load", stage(&Sample::load), headers, counters.declsVisited);
+    PrintStage("extract", stage(&Sample::extract), headers, counters.declsVisited);
+    //parse and traverse are summed over all threads, with multiple jobs they exceed the extract stage
+    PrintStage("  parse", stage(&Sample::parse), headers, counters.declsVisited);
+    PrintStage("  traverse", stage(&Sample::traverse), headers, counters.declsVisited);
+    PrintStage("generate", stage(&Sample::generate), headers, counters.declsVisited);
+    PrintStage("write", stage(&Sample::write), headers, counters.declsVisited);
+    PrintStage("total", stage(&Sample::total), headers, counters.declsVisited);
+
+    std::cout.flags(flags);
+
+    return 0;
+}
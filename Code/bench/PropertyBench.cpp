@@ -0,0 +1,100 @@
+#include "PropertyBench.hpp"
+
+#include "PropertyParser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    //the implementation GetProperties used before PropertyParser, kept as the baseline
+    std::vector<Property> LegacyParseProperties(const std::string &keyword, const std::string &propertiesString) {
+        std::vector<std::string> properties{};
+        std::string::size_type pos = 0;
+        std::string::size_type prev = 0;
+        while ((pos = propertiesString.find(',', pos)) != std::string::npos) {
+            properties.emplace_back(propertiesString.substr(prev, pos - prev));
+            prev = ++pos;
+        }
+        properties.emplace_back(propertiesString.substr(prev, pos - prev));
+
+        std::vector<Property> result{{keyword}};
+        for (const auto &property: properties) {
+            auto equalsPos = property.find('=');
+            auto name = property.substr(0, equalsPos);
+            auto value = property.substr(equalsPos + 1);
+
+            name.erase(std::remove_if(name.begin(), name.end(), [](char c) { return std::isspace(c); }), name.end());
+            value.erase(std::remove_if(value.begin(), value.end(), [](char c) { return std::isspace(c); }), value.end());
+
+            result.emplace_back(Property{name, value});
+        }
+
+        return result;
+    }
+
+    std::vector<Property> ParseProperties(const std::string &keyword, const std::string &propertiesString) {
+        std::vector<Property> result{{keyword}};
+        PropertyParser::Parse(propertiesString, result);
+        return result;
+    }
+
+    //keeps the optimizer from removing the parsing
+    size_t sink = 0;
+
+    template<typename Function>
+    double MeasureNanoseconds(const std::string &input, size_t iterations, Function function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            sink += function("CGMEMBER", input).size();
+        }
+        const auto duration = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(duration).count() / static_cast<double>(iterations);
+    }
+}
+
+int RunPropertyBenchmark(int argc, char *argv[]) {
+    size_t iterations = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument{argv[i]};
+        if (argument == "--iterations" && i + 1 < argc) {
+            iterations = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Error: unknown argument " << argument << std::endl;
+            return 1;
+        }
+    }
+
+    //the inputs the legacy implementation supports, and the ones only PropertyParser supports
+    const std::vector<std::string> inputs{
+            "LuaInspect",
+            "LuaInspect, Serialize",
+            "LuaInspect, Serialize, Name=Health, Min=0, Max=100, Step=0.5",
+    };
+    const std::vector<std::string> extendedInputs{
+            R"(Name="Health, in points", Range={Min=0, Max=100}, Flags={Serialize, LuaInspect})",
+    };
+
+    const auto flags = std::cout.flags();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Iterations: " << iterations << std::endl;
+    std::cout << "Legacy (ns)  Parser (ns)  Input" << std::endl;
+
+    for (const auto &input: inputs) {
+        std::cout << std::setw(11) << MeasureNanoseconds(input, iterations, LegacyParseProperties)
+                  << std::setw(13) << MeasureNanoseconds(input, iterations, ParseProperties)
+                  << "  " << input << std::endl;
+    }
+    for (const auto &input: extendedInputs) {
+        std::cout << std::setw(11) << "-"
+                  << std::setw(13) << MeasureNanoseconds(input, iterations, ParseProperties)
+                  << "  " << input << std::endl;
+    }
+
+    std::cout.flags(flags);
+    return sink == 0 ? 1 : 0;
+}
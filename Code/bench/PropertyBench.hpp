@@ -0,0 +1,10 @@
+#ifndef CODEGENERATOR_PROPERTYBENCH_HPP
+#define CODEGENERATOR_PROPERTYBENCH_HPP
+
+/// \brief compares PropertyParser with the comma splitting GetProperties used before it
+/// \param argc amount of arguments, the first argument is the name of the benchmark
+/// \param argv the arguments, only --iterations N is supported
+/// \return the exit code
+int RunPropertyBenchmark(int argc, char *argv[]);
+
+#endif //CODEGENERATOR_PROPERTYBENCH_HPP
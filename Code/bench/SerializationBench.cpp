@@ -0,0 +1,278 @@
+#include "SerializationBench.hpp"
+
+#include <CodeGenerator/Serialization.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Bench {
+    //a typical save game entity, annotated with CGCLASS(Serialize) and CGMEMBER on every member
+    struct Snapshot {
+        uint64_t id = 0;
+        float position[3]{};
+        float velocity[3]{};
+        float rotation[4]{};
+        int32_t health = 0;
+        int32_t armor = 0;
+        std::string name{};
+        std::vector<uint32_t> inventory{};
+        uint16_t level = 0;
+        bool alive = false;
+    };
+}
+
+//what SerializationGenerator emits for Bench::Snapshot, checked in so the benchmark needs no generator run
+namespace CodeGenerator {
+    template<>
+    struct Serializer<::Bench::Snapshot> {
+        static constexpr size_t fixedSize = (offsetof(::Bench::Snapshot, armor) + sizeof(::Bench::Snapshot::armor) - offsetof(::Bench::Snapshot, id)) + GetFixedSize<decltype(::Bench::Snapshot::name)>() + GetFixedSize<decltype(::Bench::Snapshot::inventory)>() + (offsetof(::Bench::Snapshot, alive) + sizeof(::Bench::Snapshot::alive) - offsetof(::Bench::Snapshot, level));
+
+        static void Write(Buffer &buffer, const ::Bench::Snapshot &object) {
+            buffer.Grow(fixedSize);
+            buffer.WriteBytes(&object.id, (offsetof(::Bench::Snapshot, armor) + sizeof(::Bench::Snapshot::armor) - offsetof(::Bench::Snapshot, id)));
+            CodeGenerator::Write(buffer, object.name);
+            CodeGenerator::Write(buffer, object.inventory);
+            buffer.WriteBytes(&object.level, (offsetof(::Bench::Snapshot, alive) + sizeof(::Bench::Snapshot::alive) - offsetof(::Bench::Snapshot, level)));
+        }
+
+        static bool Read(Reader &reader, ::Bench::Snapshot &object) {
+            if (!reader.ReadBytes(&object.id, (offsetof(::Bench::Snapshot, armor) + sizeof(::Bench::Snapshot::armor) - offsetof(::Bench::Snapshot, id)))) {
+                return false;
+            }
+            if (!CodeGenerator::Read(reader, object.name)) {
+                return false;
+            }
+            if (!CodeGenerator::Read(reader, object.inventory)) {
+                return false;
+            }
+            if (!reader.ReadBytes(&object.level, (offsetof(::Bench::Snapshot, alive) + sizeof(::Bench::Snapshot::alive) - offsetof(::Bench::Snapshot, level)))) {
+                return false;
+            }
+            return true;
+        }
+    };
+}
+
+namespace {
+    using Bench::Snapshot;
+
+    //the generic reflection serializer used before, one virtual call per field and per element
+    class FieldSerializer {
+    public:
+        virtual ~FieldSerializer() = default;
+
+        virtual void Write(std::vector<std::byte> &buffer, const Snapshot &object) const = 0;
+
+        virtual bool Read(const std::vector<std::byte> &buffer, size_t &position, Snapshot &object) const = 0;
+    };
+
+    void AppendBytes(std::vector<std::byte> &buffer, const void *bytes, size_t size) {
+        const auto *begin = static_cast<const std::byte *>(bytes);
+        buffer.insert(buffer.end(), begin, begin + size);
+    }
+
+    bool ExtractBytes(const std::vector<std::byte> &buffer, size_t &position, void *bytes, size_t size) {
+        if (size > buffer.size() - position) {
+            return false;
+        }
+        std::memcpy(bytes, buffer.data() + position, size);
+        position += size;
+        return true;
+    }
+
+    template<typename T>
+    class ValueSerializer : public FieldSerializer {
+        T Snapshot::*member;
+    public:
+        explicit ValueSerializer(T Snapshot::*member) : member(member) {};
+
+        void Write(std::vector<std::byte> &buffer, const Snapshot &object) const override {
+            AppendBytes(buffer, &(object.*member), sizeof(T));
+        };
+
+        bool Read(const std::vector<std::byte> &buffer, size_t &position, Snapshot &object) const override {
+            return ExtractBytes(buffer, position, &(object.*member), sizeof(T));
+        };
+    };
+
+    class StringSerializer : public FieldSerializer {
+    public:
+        void Write(std::vector<std::byte> &buffer, const Snapshot &object) const override {
+            const uint64_t size = object.name.size();
+            AppendBytes(buffer, &size, sizeof(size));
+            AppendBytes(buffer, object.name.data(), object.name.size());
+        };
+
+        bool Read(const std::vector<std::byte> &buffer, size_t &position, Snapshot &object) const override {
+            uint64_t size = 0;
+            if (!ExtractBytes(buffer, position, &size, sizeof(size)) || size > buffer.size() - position) {
+                return false;
+            }
+            object.name.resize(static_cast<size_t>(size));
+            return ExtractBytes(buffer, position, object.name.data(), object.name.size());
+        };
+    };
+
+    class InventorySerializer : public FieldSerializer {
+    public:
+        void Write(std::vector<std::byte> &buffer, const Snapshot &object) const override {
+            const uint64_t size = object.inventory.size();
+            AppendBytes(buffer, &size, sizeof(size));
+            for (const auto &item: object.inventory) {
+                AppendBytes(buffer, &item, sizeof(item));
+            }
+        };
+
+        bool Read(const std::vector<std::byte> &buffer, size_t &position, Snapshot &object) const override {
+            uint64_t size = 0;
+            if (!ExtractBytes(buffer, position, &size, sizeof(size))) {
+                return false;
+            }
+            object.inventory.clear();
+            for (uint64_t i = 0; i < size; ++i) {
+                if (!ExtractBytes(buffer, position, &object.inventory.emplace_back(), sizeof(uint32_t))) {
+                    return false;
+                }
+            }
+            return true;
+        };
+    };
+
+    std::vector<std::unique_ptr<FieldSerializer>> CreateFieldSerializers() {
+        std::vector<std::unique_ptr<FieldSerializer>> fields{};
+        fields.emplace_back(std::make_unique<ValueSerializer<uint64_t>>(&Snapshot::id));
+        fields.emplace_back(std::make_unique<ValueSerializer<float[3]>>(&Snapshot::position));
+        fields.emplace_back(std::make_unique<ValueSerializer<float[3]>>(&Snapshot::velocity));
+        fields.emplace_back(std::make_unique<ValueSerializer<float[4]>>(&Snapshot::rotation));
+        fields.emplace_back(std::make_unique<ValueSerializer<int32_t>>(&Snapshot::health));
+        fields.emplace_back(std::make_unique<ValueSerializer<int32_t>>(&Snapshot::armor));
+        fields.emplace_back(std::make_unique<StringSerializer>());
+        fields.emplace_back(std::make_unique<InventorySerializer>());
+        fields.emplace_back(std::make_unique<ValueSerializer<uint16_t>>(&Snapshot::level));
+        fields.emplace_back(std::make_unique<ValueSerializer<bool>>(&Snapshot::alive));
+        return fields;
+    }
+
+    std::vector<Snapshot> CreateSnapshots(size_t count) {
+        std::vector<Snapshot> snapshots(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto &snapshot = snapshots[i];
+            snapshot.id = i;
+            snapshot.position[0] = static_cast<float>(i);
+            snapshot.health = static_cast<int32_t>(i % 100);
+            snapshot.name = "Entity" + std::to_string(i);
+            snapshot.inventory.assign(i % 16, static_cast<uint32_t>(i));
+            snapshot.level = static_cast<uint16_t>(i % 50);
+            snapshot.alive = i % 2 == 0;
+        }
+        return snapshots;
+    }
+
+    struct Result {
+        double writeSeconds = 0;
+        double readSeconds = 0;
+        size_t bytes = 0;
+    };
+
+    template<typename Function>
+    double MeasureSeconds(size_t iterations, Function function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            function();
+        }
+        const auto duration = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    Result MeasureGenerated(const std::vector<Snapshot> &snapshots, size_t iterations) {
+        Result result{};
+        CodeGenerator::Buffer buffer{};
+        result.writeSeconds = MeasureSeconds(iterations, [&]() {
+            buffer.Clear();
+            for (const auto &snapshot: snapshots) {
+                CodeGenerator::Write(buffer, snapshot);
+            }
+        });
+        result.bytes = buffer.GetSize();
+
+        std::vector<Snapshot> read(snapshots.size());
+        result.readSeconds = MeasureSeconds(iterations, [&]() {
+            CodeGenerator::Reader reader{buffer};
+            for (auto &snapshot: read) {
+                CodeGenerator::Read(reader, snapshot);
+            }
+        });
+        return result;
+    }
+
+    Result MeasureVirtual(const std::vector<Snapshot> &snapshots, size_t iterations) {
+        const auto fields = CreateFieldSerializers();
+
+        Result result{};
+        std::vector<std::byte> buffer{};
+        result.writeSeconds = MeasureSeconds(iterations, [&]() {
+            buffer.clear();
+            for (const auto &snapshot: snapshots) {
+                for (const auto &field: fields) {
+                    field->Write(buffer, snapshot);
+                }
+            }
+        });
+        result.bytes = buffer.size();
+
+        std::vector<Snapshot> read(snapshots.size());
+        result.readSeconds = MeasureSeconds(iterations, [&]() {
+            size_t position = 0;
+            for (auto &snapshot: read) {
+                for (const auto &field: fields) {
+                    field->Read(buffer, position, snapshot);
+                }
+            }
+        });
+        return result;
+    }
+
+    double GetThroughput(size_t bytes, size_t iterations, double seconds) {
+        return static_cast<double>(bytes) * static_cast<double>(iterations) / seconds / (1024.0 * 1024.0);
+    }
+}
+
+int RunSerializationBenchmark(int argc, char *argv[]) {
+    size_t iterations = 100;
+    size_t objects = 10000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument{argv[i]};
+        if (argument == "--iterations" && i + 1 < argc) {
+            iterations = std::stoul(argv[++i]);
+        } else if (argument == "--objects" && i + 1 < argc) {
+            objects = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Error: unknown argument " << argument << std::endl;
+            return 1;
+        }
+    }
+
+    const auto snapshots = CreateSnapshots(objects);
+    const auto generated = MeasureGenerated(snapshots, iterations);
+    const auto virtualCalls = MeasureVirtual(snapshots, iterations);
+
+    const auto flags = std::cout.flags();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Objects: " << objects << ", iterations: " << iterations << std::endl;
+    std::cout << "Serializer    Write (MiB/s)  Read (MiB/s)  Bytes" << std::endl;
+    std::cout << "Generated  " << std::setw(16) << GetThroughput(generated.bytes, iterations, generated.writeSeconds)
+              << std::setw(14) << GetThroughput(generated.bytes, iterations, generated.readSeconds)
+              << "  " << generated.bytes << std::endl;
+    std::cout << "Virtual    " << std::setw(16) << GetThroughput(virtualCalls.bytes, iterations, virtualCalls.writeSeconds)
+              << std::setw(14) << GetThroughput(virtualCalls.bytes, iterations, virtualCalls.readSeconds)
+              << "  " << virtualCalls.bytes << std::endl;
+    std::cout.flags(flags);
+
+    return 0;
+}
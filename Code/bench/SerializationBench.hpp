@@ -0,0 +1,10 @@
+#ifndef CODEGENERATOR_SERIALIZATIONBENCH_HPP
+#define CODEGENERATOR_SERIALIZATIONBENCH_HPP
+
+/// \brief compares the generated serializer with serializing every field through a virtual call
+/// \param argc amount of arguments, the first argument is the name of the benchmark
+/// \param argv the arguments, --iterations N and --objects N are supported
+/// \return the exit code
+int RunSerializationBenchmark(int argc, char *argv[]);
+
+#endif //CODEGENERATOR_SERIALIZATIONBENCH_HPP
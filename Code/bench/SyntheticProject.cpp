@@ -0,0 +1,110 @@
+#include "SyntheticProject.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    std::string GetHeaderName(size_t index) {
+        return "Header" + std::to_string(index) + ".hpp";
+    }
+
+    //the markers expand to nothing, the code generator reads them from the source
+    void WriteAnnotations(const std::filesystem::path &file) {
+        std::ofstream output{file};
+        output << "#pragma once\n\n"
+               << "#define CGCLASS(...)\n"
+               << "#define CGMEMBER(...)\n"
+               << "#define CGMETHOD(...)\n";
+    }
+
+    void WriteHeader(const std::filesystem::path &file, size_t index, const SyntheticProjectOptions &options) {
+        std::ofstream output{file};
+        output << "#pragma once\n\n"
+               << "#include \"Annotations.hpp\"\n";
+
+        //headers form chains of includeDepth + 1 headers, each header includes the previous one in its chain
+        if (options.includeDepth > 0 && index % (options.includeDepth + 1) != 0) {
+            output << "#include \"" << GetHeaderName(index - 1) << "\"\n";
+        }
+
+        output << "\nnamespace Bench" << index << " {\n";
+
+        for (size_t c = 0; c < options.classesPerHeader; ++c) {
+            if (options.attributes) {
+                output << "\nclass [[cg::class(\"LuaClass\")]] Class" << c << " {\n";
+            } else {
+                output << "\nCGCLASS(LuaClass)\n"
+                       << "class Class" << c << " {\n";
+            }
+            output << "public:\n";
+
+            for (size_t m = 0; m < options.annotatedMembers; ++m) {
+                for (size_t l = 0; l < options.commentLines; ++l) {
+                    output << "    //documentation of member" << m << ", line " << l << "\n";
+                }
+
+                output << (options.attributes ? "    [[cg::member(\"LuaInspect\")]]\n" : "    CGMEMBER(LuaInspect)\n")
+                       << "    int member" << m << " = " << m << ";\n"
+                       << "    float unannotated" << m << " = " << m << ".0f;\n";
+            }
+
+            //a body with statements, so skipping function bodies has something to skip
+            output << (options.attributes ? "\n    [[cg::method(\"LuaInspect\")]]\n" : "\n    CGMETHOD(LuaInspect)\n")
+                   << "    int Sum() const {\n"
+                   << "        int sum = 0;\n"
+                   << "        for (int i = 0; i < " << options.annotatedMembers << "; ++i) {\n"
+                   << "            sum += i * i;\n"
+                   << "        }\n"
+                   << "        return sum;\n"
+                   << "    }\n"
+                   << "};\n";
+        }
+
+        output << "\n}\n";
+    }
+}
+
+std::filesystem::path SyntheticProject::Generate(const std::filesystem::path &directory,
+                                                 const SyntheticProjectOptions &options) {
+    std::filesystem::create_directories(directory);
+
+    WriteAnnotations(directory / "Annotations.hpp");
+
+    std::ofstream project{directory / "Bench.vcxproj"};
+    if (!project.is_open()) {
+        throw std::runtime_error("Could not write the synthetic project to " + directory.string());
+    }
+
+    project << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+            << "<Project DefaultTargets=\"Build\" xmlns=\"http://schemas.microsoft.com/developer/msbuild/2003\">\n"
+            << "  <ItemGroup>\n";
+
+    for (size_t i = 0; i < options.headers; ++i) {
+        WriteHeader(directory / GetHeaderName(i), i, options);
+        project << "    <ClInclude Include=\"" << GetHeaderName(i) << "\" />\n";
+    }
+
+    project << "  </ItemGroup>\n"
+            << "  <ItemGroup>\n";
+
+    //every header is included by a source file, like in a real project
+    for (size_t i = 0; i < options.headers; ++i) {
+        const auto source = "Source" + std::to_string(i) + ".cpp";
+
+        std::ofstream output{directory / source};
+        output << "#include \"" << GetHeaderName(i) << "\"\n";
+
+        project << "    <ClCompile Include=\"" << source << "\" />\n";
+    }
+
+    project << "  </ItemGroup>\n"
+            << "</Project>\n";
+
+    return directory / "Bench.vcxproj";
+}
+
+size_t SyntheticProject::GetAnnotatedCount(const SyntheticProjectOptions &options) {
+    //every class has its annotated members and a single annotated method
+    return options.headers * options.classesPerHeader * (1 + options.annotatedMembers + 1);
+}
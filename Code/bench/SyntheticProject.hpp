@@ -0,0 +1,38 @@
+#ifndef CODEGENERATOR_SYNTHETICPROJECT_HPP
+#define CODEGENERATOR_SYNTHETICPROJECT_HPP
+
+#include <cstddef>
+#include <filesystem>
+
+/// \brief the shape of a generated project, every knob scales a different part of the pipeline
+struct SyntheticProjectOptions {
+    //amount of headers listed in the project
+    size_t headers = 100;
+    //amount of annotated classes in every header
+    size_t classesPerHeader = 4;
+    //amount of annotated members in every class, every class gets as many unannotated members as well
+    size_t annotatedMembers = 8;
+    //length of the longest chain of project headers including each other, 0 disables includes between headers
+    size_t includeDepth = 2;
+    //lines of documentation above every annotated member, makes headers longer without adding decls
+    size_t commentLines = 0;
+    //annotate with [[cg::...]] attributes instead of markers on the line above
+    bool attributes = false;
+};
+
+/// \brief writes a synthetic vcxproj project with annotated headers, used to benchmark the code generator
+/// \note the content only depends on the options, so the same options always produce the same project
+class SyntheticProject {
+public:
+    /// \brief writes the project to the provided directory
+    /// \param directory the directory to write the project to, created if it doesn't exist
+    /// \param options the shape of the project
+    /// \return the path of the vcxproj file
+    static std::filesystem::path Generate(const std::filesystem::path &directory,
+                                          const SyntheticProjectOptions &options);
+
+    /// \brief returns the amount of annotated classes, members, and methods in a project with the provided options
+    static size_t GetAnnotatedCount(const SyntheticProjectOptions &options);
+};
+
+#endif //CODEGENERATOR_SYNTHETICPROJECT_HPP
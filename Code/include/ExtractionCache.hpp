@@ -0,0 +1,76 @@
+#ifndef CODEGENERATOR_EXTRACTIONCACHE_HPP
+#define CODEGENERATOR_EXTRACTIONCACHE_HPP
+
+#include "FileParser.hpp"
+#include "pugixml.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// \brief stores the classes, functions, and variables of every parsed header on disk
+/// \note an entry is reused when the header, every project header it includes, and the compile arguments are unchanged
+class ExtractionCache {
+    //bumped whenever the stored objects change, older caches are discarded
+    static constexpr unsigned version = 10;
+
+    std::filesystem::path file;
+    //hash of the compile arguments alone, and combined with the content of every file of the precompiled header
+    uint64_t compileHash;
+    uint64_t argumentsHash;
+
+    std::filesystem::path prelude;
+    //normalized paths of the files the precompiled header was built from, stored in the cache between runs
+    std::vector<std::string> preludeInputs;
+
+    pugi::xml_document document;
+    //normalized header path -> entry in document
+    std::unordered_map<std::string, pugi::xml_node> entries;
+    //normalized header paths that were loaded from the cache during Load
+    std::unordered_set<std::string> reused;
+    //normalized file path -> hash of the content, 0 if the file could not be read
+    std::unordered_map<std::string, uint64_t> fileHashes;
+
+    /// \brief returns the hash of the content of the file, the result is cached for the lifetime of the cache
+    uint64_t HashFile(const std::string &path);
+
+    /// \brief returns the key of the header, a combination of the content hash and the arguments hash
+    uint64_t GetKey(const std::string &header);
+
+    /// \brief tests if the entry is still valid for the current content of the header and its dependencies
+    bool IsValid(const pugi::xml_node &entry, const std::string &header);
+
+    /// \brief combines the compile arguments with the current content of the prelude and the files it includes
+    void UpdateArgumentsHash();
+public:
+    /// \param file path of the cache file
+    /// \param args the compile arguments, a change in arguments invalidates every entry
+    /// \param prelude the prelude header used for the precompiled header, empty if none
+    ExtractionCache(std::filesystem::path file, const std::vector<std::string> &args,
+                    const std::filesystem::path &prelude = {});
+
+    /// \brief loads the cache and adds a parser for every header with a valid entry to ASTFileParser::GetParsers()
+    /// \param headers the headers of the project
+    /// \return the headers that are not cached or outdated, these still have to be parsed
+    std::vector<std::filesystem::path> Load(const std::vector<std::filesystem::path> &headers);
+
+    /// \brief forgets the content of the provided files, used when files change while the cache is alive
+    /// \param files normalized paths of the changed files
+    /// \note entries of changed headers are replaced on the next Save, all entries if a file of the prelude changed
+    void Invalidate(const std::unordered_set<std::string> &files);
+
+    /// \brief sets the files the precompiled header was built from, see ToolRunner::BuildPrecompiledHeader
+    /// \param inputs normalized paths, a change to any of them invalidates every entry
+    /// \note the inputs are saved with the cache, so the next Load can check them before the prelude is compiled
+    void SetPreludeInputs(const std::vector<std::string> &inputs);
+
+    /// \brief writes the cache, reusing the loaded entries and adding an entry for every newly parsed file
+    /// \param parsers all parsers, including the ones added by Load
+    /// \return true if the cache was written
+    bool Save(const std::vector<ASTFileParser> &parsers);
+};
+
+#endif //CODEGENERATOR_EXTRACTIONCACHE_HPP
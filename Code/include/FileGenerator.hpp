@@ -20,6 +20,9 @@ struct FullFunction {
     Function header;
     
     std::vector<std::string> body;
+    
+    //the includes this function needs, a shard only includes the headers of its own functions
+    std::unordered_set<std::filesystem::path> includes;
 };
 
 struct File  {
@@ -28,6 +31,20 @@ struct File  {
     std::vector<std::string> header;
     
     std::unordered_map<std::string, FullFunction> functions;
+    
+    //functions that may be moved to a shard when sharding is enabled, the other functions stay in the file
+    std::unordered_set<std::string> shardable;
+    
+    //lines written before the header in every shard, a shard is compiled on its own and has to include what it uses
+    std::vector<std::string> shardHeader;
+};
+
+/// \brief consecutive members of a class that can be copied or compared as bytes together, see GetMemberRuns
+struct MemberRun {
+    std::vector<const Variable*> members;
+    
+    //false for a run with a single member that isn't trivially copyable or is a bit-field
+    bool isTriviallyCopyable;
 };
 
 class FileGenerator {
@@ -35,6 +52,14 @@ public:
     static std::filesystem::path output_directory;
     static std::unordered_map<std::string, File> files;
     
+    /// \brief amount of .gen.cpp shards the shardable functions of a file are spread over, 0 or 1 disables sharding
+    /// \note a function is assigned to a shard by a hash of its name, so it stays in the same shard between runs
+    static size_t shardCount;
+    
+    /// \brief USRs of the classes, functions, variables, and enums handed to the callbacks so far
+    /// \note an entity that is declared in multiple headers or translation units is only generated once
+    std::unordered_set<std::string> usrs{};
+    
     /// \brief The callback function that gets called whenever a new ASTFileParser gets parsed
     /// \param fileGenerator the FileGenerator that called this function
     /// \param parser the ASTFileParser that was parsed
@@ -67,10 +92,20 @@ public:
     /// \note this function is called for global functions, for member functions see ParseMethod
     std::function<void(FileGenerator&, const Function& functions)> ParseFunction{};
     
+    /// \brief The callback function that gets called whenever a new enum gets parsed
+    /// \param fileGenerator the FileGenerator that called this function
+    /// \param enums the enum that was parsed, including all of its enumerators
+    std::function<void(FileGenerator&, const Enum& enums)> ParseEnum{};
+    
     /// \brief The parser function responsible for calling the callback functions
     /// \param parser the ASTFileParser to parse
     void Parse(const ASTFileParser& parser);
     
+    /// \brief tests if the object is seen for the first time by this FileGenerator, based on its USR
+    /// \param object the class, function, variable, or enum to test
+    /// \return true if the callbacks should be called for the object
+    bool IsFirstDeclaration(const Object& object);
+    
     /// \brief parses the provided ASTFileParser and returns the #include macro that will include the file
     /// \param parser the ASTFileParser to get the path from
     /// \return string in the form of #include "path"
@@ -82,17 +117,92 @@ public:
     /// \return string in the form of #include "path"
     static std::string GetFileInclude(const std::filesystem::path& path);
     
+    /// \brief returns the qualified name of the object as an identifier, Game::Player becomes Game_Player
+    /// \param object the object to get the identifier for
+    /// \return the identifier, used for names of generated functions and files
+    static std::string GetIdentifier(const Object& object);
+    
+    /// \brief tests if the generated files can name the class or enum, which is not the case in an anonymous namespace
+    static bool IsNameable(const Object& object);
+    
+    /// \brief tests if the generated files can name the member, private and protected members are reported as skipped
+    /// \param class_ the class the member belongs to
+    /// \param variable the member to test
+    /// \param generated what is generated for the class, used in the warning, like "Serializer"
+    static bool IsAccessible(const Class& class_, const Variable& variable, const std::string& generated);
+    
+    /// \brief groups the public members into runs of trivially copyable members, other members get a run each
+    /// \param generated what is generated for the class, used in the warning about members that aren't public
+    /// \note a run only continues with the next member of the class, a member that isn't annotated is never included
+    static std::vector<MemberRun> GetMemberRuns(const Class& class_, const std::string& generated);
+    
+    /// \brief starts the header of a file specializing a template of the runtime for the object
+    /// \param fileName the file to write, its header is replaced
+    /// \param object the class or enum the template is specialized for, its header is included
+    /// \param runtimeHeader the runtime header declaring the template, like CodeGenerator/Reflection.hpp
+    /// \return the header, ending with template<> inside namespace CodeGenerator
+    static std::vector<std::string>& BeginSpecialization(const std::string& fileName, const Object& object,
+                                                         const std::string& runtimeHeader);
+    
+    /// \brief starts the header of a file specializing a template of the runtime for the class
+    /// \note for classes that aren't standard layout -Winvalid-offsetof is disabled until EndSpecialization
+    static std::vector<std::string>& BeginSpecialization(const std::string& fileName, const Class& class_,
+                                                         const std::string& runtimeHeader);
+    
+    /// \brief ends the header started by BeginSpecialization for the class, call after its last line
+    static void EndSpecialization(std::vector<std::string>& header, const Class& class_);
+    
     /// \brief Get the property with the provided name from the provided properties
     /// \param properties vector of properties to search in
     /// \param name name of the property to search for
     /// \return pointer to the property if found, nullptr otherwise
     static const Property* GetProperty(const std::vector<Property>& properties, const std::string& name);
     
+    /// \brief Get the property with the provided key from the provided properties, comparing keys instead of names
+    /// \param properties vector of properties to search in, for the properties of an object use Object::GetProperty
+    /// \param key interned name of the property to search for
+    /// \return pointer to the property if found, nullptr otherwise
+    static const Property* GetProperty(const std::vector<Property>& properties, PropertyKey key);
+    
     /// \brief Write all files to disk
     /// \note function names are based on their keys in the files map, not their name in the variable
     /// \code{.cpp} files["file.cpp"].functions["Name1] = {"void", "Name2", {}} \endcode
     /// \note will have the name: Name1 in file.cpp
+    /// \note files with the same content on disk are not written, so their timestamp doesn't change
     static void WriteFiles();
+    
+    /// \brief Splits the file into the file itself and shardCount shards
+    /// \param name the name of the file, the shards are named <stem>.shard<i>.gen.cpp
+    /// \param file the file to split
+    /// \return pairs of (name, file), the first is the file without its shardable functions
+    /// \note a shard has the shard header and the header of the file, and only includes the headers its functions need
+    static std::vector<std::pair<std::string, File>> ShardFile(const std::string& name, const File& file);
+    
+    /// \brief returns the name of a shard of the file, LuaBindings.cpp.gen becomes LuaBindings.shard<index>.gen.cpp
+    static std::string GetShardName(const std::string& name, size_t index);
+    
+    /// \brief deletes the shards of the file with an index of at least count, left behind by a larger shard count
+    /// \param name the name of the file the shards belong to
+    /// \param count the amount of shards written in this run, 0 if the file wasn't sharded
+    static void RemoveStaleShards(const std::string& name, size_t count);
+    
+    /// \brief Renders the file to a string, includes and functions are sorted so the output is stable
+    /// \param file the file to render
+    /// \return the content of the file as it would be written to disk
+    static std::string RenderFile(const File& file);
+    
+    enum class WriteResult {
+        Written,
+        Unchanged,
+        Failed
+    };
+    
+    /// \brief Writes the content to the path if the file doesn't already contain it
+    /// \param path the file to write
+    /// \param content the content to write
+    /// \return whether the file was written, unchanged, or could not be written
+    /// \note the content is written to a temporary file first, which then replaces the file
+    static WriteResult WriteIfChanged(const std::filesystem::path& path, const std::string& content);
 };
 
 #endif //CODEGENERATOR_FILEGENERATOR_HPP
@@ -3,40 +3,76 @@
 
 #include <clang/AST/RecursiveASTVisitor.h>
 #include <clang/Frontend/FrontendActions.h>
+#include <llvm/ADT/ArrayRef.h>
 
 #include <utility>
 #include <vector>
 #include <stack>
-#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "Objects.hpp"
+#include "Statistics.hpp"
 
 /// \brief parses a file and stores the data in the objects
 /// \note this class serves both as a parser and a container for the data
 class ASTFileParser : public clang::RecursiveASTVisitor<ASTFileParser> {
     static std::vector<ASTFileParser> parsers;
+    //guards parsers, translation units may be handled on multiple threads at once
+    static std::mutex parsersMutex;
+    //headers that decls are attributed to in unity and sources mode, empty when both are disabled
+    static std::unordered_set<std::string> unityHeaders;
+    //headers a translation unit has already taken, each header is parsed by one translation unit only
+    static std::unordered_set<std::string> claimedHeaders;
+    //all headers of the project, used to find which project headers a file depends on
+    static std::unordered_set<std::string> projectHeaders;
+    //only traverse the decls of the main file and skip all statements, see SetFastTraversal
+    static bool fastTraversal;
     int skipped_parameters = 0;
+    //counted per parser and reported once per translation unit, see Statistics
+    uint64_t decls_visited = 0;
+    uint64_t decls_skipped = 0;
+    uint64_t decls_skipped_by_file_id = 0;
+    uint64_t annotated_entities = 0;
 
     friend class ASTConsumer;
+    friend class ASTFrontendAction;
     friend class FileGenerator;
+    friend class ExtractionCache;
 
     std::vector<Class> classes;
     std::vector<Function> functions;
     std::vector<Variable> variables;
+    std::vector<Enum> enums;
 
     std::stack<size_t> classStack;
     std::stack<Function> functionStack;
 
-    std::ifstream file;
-    
     std::filesystem::path path;
 
+    //the file decls are parsed from, resolved once per translation unit, see DeclIsIncluded
+    clang::FileID mainFileID{};
+    const clang::FileEntry *mainFileEntry = nullptr;
+    //the last file a decl was rejected for, decls of included files are rejected without a lookup
+    clang::FileID includedFileID{};
+
+    //normalized paths of the project headers this file includes, directly or indirectly
+    std::vector<std::string> dependencies;
+
+    //type of the first decl starting at (FileID, offset) and its spelling, see GetTypeAsString
+    std::unordered_map<uint64_t, std::pair<clang::QualType, std::string>> typeSpellings;
+
     /// \brief parses the properties of the decl
     /// \param decl decl to parse properties for
     /// \return vector of properties
     /// \note Properties should be in the form of a comma separated list, A property is defined as follows:
     /// \note [name]=[value] (value is optional and will be empty if not provided)
+    /// \note values can be quoted strings or nested {...} lists, see PropertyParser for the full grammar
     /// \note A property list should be directly above the decl and may not span multiple lines
+    /// \note Alternatively the decl can be annotated in the AST, CGCLASS(LuaClass) can be written as:
+    /// \note [[cg::class("LuaClass")]], [[clang::annotate("cg:class(LuaClass)")]],
+    /// \note or __attribute__((annotate("cg:class(LuaClass)"))), annotations are preferred over the line above
     std::vector<Property> GetProperties(const clang::Decl &decl, std::string keyword = "CGCLASS");
 
     /// \brief returns the line above the decl
@@ -44,12 +80,25 @@ class ASTFileParser : public clang::RecursiveASTVisitor<ASTFileParser> {
     /// \return line above the decl or empty string if decl starts at the beginning of the file
     std::string GetLineAbove(const clang::Decl &decl);
 
-    /// \brief returns the type of the decl as a string exactly as it appears in the source code
+    /// \brief returns the type of the decl as a string as it appears in the source code
     /// \param type decl of the type to get
-    /// \return type as a string
-    static std::string GetTypeAsString(const clang::NamedDecl &type);
+    /// \return type as a string, tokens are separated by at most a single space and static is removed
+    /// \note the type is read with a raw lexer from the start of the decl up to its name, attributes are skipped
+    std::string GetTypeAsString(const clang::NamedDecl &type);
 
+    /// \brief tests if the decl is declared in a file other than the main file of the parser
+    /// \note compares FileIDs, the file of the decl is only looked up the first time a FileID is seen
     bool DeclIsIncluded(const clang::Decl &decl);
+
+    /// \brief claims the header for the calling translation unit
+    /// \param header normalized path of the header
+    /// \return true if no other translation unit claimed the header before
+    static bool ClaimHeader(const std::string &header);
+
+    /// \brief sets the file decls are parsed from, must be called before traversing
+    /// \param sourceManager the source manager of the translation unit
+    /// \param fileID the FileID of the main file, or of the header in unity mode
+    void SetMainFile(const clang::SourceManager &sourceManager, clang::FileID fileID);
 public:
     explicit ASTFileParser(std::filesystem::path file) : path(std::move(file)) {};
 
@@ -61,6 +110,59 @@ public:
     static const std::vector<ASTFileParser> &GetParsers() {
         return parsers;
     };
+
+    /// \brief sorts the parsers to match the order of the provided files
+    /// \param order the files in the order the parsers should be in
+    /// \note parsers for files that are not in order are placed at the end, sorted by path
+    static void SortParsers(const std::vector<std::string> &order);
+
+    /// \brief enables unity mode, each translation unit may include many project headers
+    /// \param headers the project headers to attribute decls to, empty to disable unity mode
+    /// \note in unity mode a separate parser is created for every project header found in the translation unit,
+    /// \note a header reached by multiple translation units is only parsed by the first, this resets the claims
+    static void SetUnityHeaders(const std::vector<std::filesystem::path> &headers);
+
+    /// \brief tests if a translation unit parsed the header since the last call to SetUnityHeaders
+    static bool IsHeaderClaimed(const std::filesystem::path &header);
+
+    /// \brief enables the fast traversal mode
+    /// \param enabled true to enable fast traversal
+    /// \note only top level decls of the main file are traversed, statements are skipped entirely,
+    /// \note and clang is told to skip function bodies while parsing
+    static void SetFastTraversal(bool enabled) {
+        fastTraversal = enabled;
+    };
+
+    /// \brief sets the headers of the project, these are tracked as dependencies of every parsed file
+    /// \param headers all headers of the project
+    static void SetProjectHeaders(const std::vector<std::filesystem::path> &headers);
+
+    /// \brief returns the absolute, lexically normal form of the path
+    /// \param path path to normalize
+    /// \return normalized path as a string, used to compare paths that are spelled differently
+    static std::string NormalizePath(const std::filesystem::path &path);
+
+    /// \brief removes the parsers of the provided files
+    /// \param files normalized paths of the files to remove, see NormalizePath
+    static void RemoveParsers(const std::unordered_set<std::string> &files);
+
+    static void ClearParsers() {
+        std::lock_guard lock{parsersMutex};
+        parsers.clear();
+    };
+
+    [[nodiscard]] const std::filesystem::path &GetPath() const {
+        return path;
+    };
+
+    [[nodiscard]] const std::vector<std::string> &GetDependencies() const {
+        return dependencies;
+    };
+
+    /// \brief tests if the parser found any classes, functions, variables, or enums
+    [[nodiscard]] bool IsEmpty() const {
+        return classes.empty() && functions.empty() && variables.empty() && enums.empty();
+    };
     
     //Traversal methods, each method handles a specific type of decl and parses it
     //CXXRecordDecl is a class, struct, or union
@@ -70,6 +172,7 @@ public:
     //ParmVarDecl is a parameter, this is a variable inside a function
     //VarDecl is a variable, this is a variable inside a function or global variable
     //FunctionDecl is a function, this is a function outside a class
+    //EnumDecl is an enum or enum class, inside or outside a class
 
     bool TraverseCXXRecordDecl(clang::CXXRecordDecl *decl);
 
@@ -84,16 +187,44 @@ public:
     bool TraverseVarDecl(clang::VarDecl *decl);
 
     bool TraverseFunctionDecl(clang::FunctionDecl *decl);
+
+    bool TraverseEnumDecl(clang::EnumDecl *decl);
+
+    //annotations are never inside statements, in fast traversal mode statements are not traversed at all
+    bool TraverseStmt(clang::Stmt *stmt, DataRecursionQueue *queue = nullptr);
+
+    //template instantiations and implicit code are never annotated in the source
+    bool shouldVisitTemplateInstantiations() const { return false; };
+
+    bool shouldVisitImplicitCode() const { return false; };
 };
 
 //implement consumer
 class ASTConsumer : public clang::ASTConsumer {
+    //time spent traversing, owned by the frontend action that created the consumer
+    Statistics::Duration &traversalTime;
+
+    /// \brief attributes every top level decl to the project header it is declared in and parses it
+    /// \param context the context of the unity translation unit
+    static void HandleUnityTranslationUnit(clang::ASTContext &context);
+
+    /// \brief adds the counters of the parsers to Statistics and prints the skipped parameters
+    static void ReportCounters(llvm::ArrayRef<ASTFileParser> parsers);
 public:
+    explicit ASTConsumer(Statistics::Duration &traversalTime) : traversalTime(traversalTime) {};
+
     void HandleTranslationUnit(clang::ASTContext &context) override;
 };
 
 //implement frontend action
 class ASTFrontendAction : public clang::SyntaxOnlyAction {
+    Statistics::Clock::time_point start;
+    Statistics::Duration traversalTime{};
+protected:
+    bool BeginInvocation(clang::CompilerInstance &compilerInstance) override;
+
+    //reports the parse and traversal time of the file to Statistics
+    void EndSourceFileAction() override;
 public:
     std::unique_ptr<clang::ASTConsumer>
     CreateASTConsumer(clang::CompilerInstance &compilerInstance, llvm::StringRef inFile) override;
@@ -0,0 +1,37 @@
+#ifndef CODEGENERATOR_FILEWATCHER_HPP
+#define CODEGENERATOR_FILEWATCHER_HPP
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// \brief watches directories for changed files
+/// \note uses inotify on linux, other platforms fall back to polling the modification times
+class FileWatcher {
+#ifdef __linux__
+    int descriptor = -1;
+    //watch descriptor -> watched directory
+    std::unordered_map<int, std::filesystem::path> watches;
+#else
+    std::vector<std::filesystem::path> directories;
+    //file -> last known modification time
+    std::unordered_map<std::string, std::filesystem::file_time_type> timestamps;
+
+    /// \brief updates the timestamps and returns the files that were added, changed or removed since the last scan
+    std::vector<std::filesystem::path> Scan();
+#endif
+public:
+    /// \param directories the directories to watch, subdirectories are not watched
+    explicit FileWatcher(const std::vector<std::filesystem::path> &directories);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    /// \brief blocks until at least one file in the watched directories changed
+    /// \return the files that changed, events that happen shortly after each other are returned together
+    std::vector<std::filesystem::path> Wait();
+};
+
+#endif //CODEGENERATOR_FILEWATCHER_HPP
@@ -0,0 +1,21 @@
+#ifndef CODEGENERATOR_HASHGENERATOR_HPP
+#define CODEGENERATOR_HASHGENERATOR_HPP
+
+#include "FileGenerator.hpp"
+#include "Objects.hpp"
+
+#include <string>
+
+/// \brief generates Hash/<class>.gen.hpp for every class with the Hashable property
+/// \note the files specialize CodeGenerator::Hasher and std::hash, and define operator== and operator!= in the
+/// \note namespace of the class, so the class must not declare its own; runs of members without padding are
+/// \note compared with memcmp and hashed as bytes, other members one by one
+class HashGenerator {
+public:
+    static void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+
+    /// \brief returns the name of the generated file for the class, relative to the output directory
+    static std::string GetFileName(const Object &object);
+};
+
+#endif //CODEGENERATOR_HASHGENERATOR_HPP
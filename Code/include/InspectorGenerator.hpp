@@ -0,0 +1,20 @@
+#ifndef CODEGENERATOR_INSPECTORGENERATOR_HPP
+#define CODEGENERATOR_INSPECTORGENERATOR_HPP
+
+#include "FileGenerator.hpp"
+#include "Objects.hpp"
+
+#include <string>
+
+/// \brief generates Inspector/<class>.gen.hpp for every LuaClass, a minimal perfect hash of its LuaInspect members
+/// \note the files specialize CodeGenerator::Inspector from the runtime header CodeGenerator/Inspector.hpp,
+/// \note so CodeGenerator::SetByName and GetByName find a member with one hash and one string comparison
+class InspectorGenerator {
+public:
+    static void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+
+    /// \brief returns the name of the generated file for the class, relative to the output directory
+    static std::string GetFileName(const Object &object);
+};
+
+#endif //CODEGENERATOR_INSPECTORGENERATOR_HPP
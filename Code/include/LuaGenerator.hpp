@@ -0,0 +1,48 @@
+#ifndef CODEGENERATOR_LUAGENERATOR_HPP
+#define CODEGENERATOR_LUAGENERATOR_HPP
+
+#include "FileGenerator.hpp"
+#include "Objects.hpp"
+
+#include <map>
+#include <string>
+
+/// \brief generates sol2 bindings in LuaBindings.cpp.gen for every class marked with LuaClass
+/// \note members and methods marked with LuaInspect are added to the usertype of their class
+/// \note every class gets its own registration function, CreateBindings either calls all of them (eager),
+/// \note or registers a usertype the first time a script reads its global (lazy, the default)
+class LuaGenerator {
+    //the class the members and methods that are parsed next belong to
+    static const Class *currentClass;
+    //Lua name -> registration function, sorted so the lazy lookup table can be binary searched
+    static std::map<std::string, std::string> registrars;
+    static bool eagerRegistration;
+
+    static constexpr const char *fileName = "LuaBindings.cpp.gen";
+
+    /// \brief returns the name of the function that registers the usertype of the class
+    static std::string GetRegistrarName(const Class &class_);
+
+    /// \brief tests if the usertype of the class is registered, false for classes that aren't a LuaClass
+    /// \note the Lua name of a class is its name without namespaces, only the first class with a name is registered
+    static bool IsRegistered(const Class &class_);
+public:
+    /// \brief registers every usertype in CreateBindings instead of when it is first used
+    static void SetEagerRegistration(bool enabled) {
+        eagerRegistration = enabled;
+    };
+
+    /// \brief forgets the classes of the previous run, call before parsing
+    static void Reset();
+
+    static void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+
+    static void HandleMember(FileGenerator &fileGenerator, const Variable &variable);
+
+    static void HandleMethod(FileGenerator &fileGenerator, const Function &function);
+
+    /// \brief writes CreateBindings and the declarations of the registration functions, call after parsing
+    static void WriteBindings();
+};
+
+#endif //CODEGENERATOR_LUAGENERATOR_HPP
@@ -7,6 +7,9 @@
 #include <vector>
 #include <filesystem>
 #include <unordered_map>
+#include <cstdint>
+
+#include "PropertyKey.hpp"
 
 //enum class AccessLevel {
 //    None,
@@ -22,6 +25,8 @@ struct Property {
     //value can be either a single string or a comma seperated list of properties
     //EG. "name"="value" or "name"={ "name"="value", "name"="value" }
     std::variant<std::string, std::vector<Property>> value;
+    //the interned name, set by the parser so lookups compare keys instead of names
+    PropertyKey key{};
 };
 
 /// \brief represents an object, an object is a name, a namespace, a path, and a list of properties
@@ -31,12 +36,64 @@ struct Object {
     std::string fullNamespace;
     std::filesystem::path path;
     std::vector<Property> properties{};
+    //unified symbol resolution, identifies the entity across translation units, empty if clang couldn't create one
+    std::string usr{};
+    //one bit per key of the properties, see SetProperties
+    uint64_t propertyMask = 0;
+    
+    /// \brief replaces the properties and indexes their keys for HasProperty and GetProperty
+    /// \note properties must be set through this, a property added to properties directly is not found by key
+    void SetProperties(std::vector<Property> newProperties) {
+        properties = std::move(newProperties);
+        propertyMask = 0;
+        for (auto& property : properties) {
+            if (property.key.IsEmpty()) {
+                property.key = PropertyKey::Intern(property.name);
+            }
+            propertyMask |= GetPropertyBit(property.key);
+        }
+    }
+    
+    [[nodiscard]] bool HasProperty(PropertyKey key) const {
+        return GetProperty(key) != nullptr;
+    }
+    
+    /// \brief returns the property with the key, or nullptr if the object does not have it
+    [[nodiscard]] const Property* GetProperty(PropertyKey key) const {
+        //most lookups are for properties the object does not have, the mask rejects those without a scan
+        if ((propertyMask & GetPropertyBit(key)) == 0) {
+            return nullptr;
+        }
+        
+        //objects have a handful of properties, comparing their keys beats hashing
+        for (const auto& property : properties) {
+            if (property.key == key) {
+                return &property;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    static constexpr uint64_t GetPropertyBit(PropertyKey key) {
+        return uint64_t{1} << (key.GetId() % 64);
+    }
 };
 
 /// \brief represents a variable, a variable is an object with a type
 struct Variable : public Object {
     std::string type = "int";
     //std::string value;
+    //layout of member variables, used to copy runs of trivially copyable members at once
+    bool isTriviallyCopyable = false;
+    bool isBitField = false;
+    bool isArray = false;
+    bool isReference = false;
+    bool isConst = false;
+    //index of the member in its class, counting members that aren't annotated as well
+    unsigned fieldIndex = 0;
+    //private and protected members can't be named by generated code outside the class
+    bool isPublic = true;
     
     //default constructor
     Variable() = default;
@@ -74,8 +131,26 @@ struct Function : public Object {
     }
 };
 
+/// \brief represents a constant of an enum, the value is stored as a signed 64-bit integer
+struct Enumerator : public Object {
+    int64_t value = 0;
+};
+
+/// \brief represents an enum, an enum is an object with an underlying type and a list of enumerators
+/// \note all enumerators are stored, in declaration order, enumerators are not annotated themselves
+struct Enum : public Object {
+    std::string underlyingType = "int";
+    bool isScoped = false;
+    std::vector<Enumerator> enumerators{};
+};
+
 /// \brief represents a class, a class is an object with a list of variables and a list of functions
 struct Class : public Object {
+    //the namespace the class is declared in, without the enclosing classes, empty for the global namespace
+    std::string enclosingNamespace{};
+    //offsetof is only supported for standard layout classes, and never for members of classes with virtual bases
+    bool isStandardLayout = true;
+    bool hasVirtualBases = false;
     std::vector<Variable> variables{};
     std::vector<Function> functions{};
 };
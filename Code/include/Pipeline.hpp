@@ -0,0 +1,61 @@
+#ifndef CODEGENERATOR_PIPELINE_HPP
+#define CODEGENERATOR_PIPELINE_HPP
+
+#include "SimpleOptionParser.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// \brief optional command line arguments, these follow the solution file and output directory
+struct Options {
+    //amount of threads used to parse the headers, 0 uses one thread per core
+    unsigned jobs = 1;
+    //parse all headers through in-memory unity translation units instead of one translation unit per header
+    bool unity = false;
+    //parse the sources of the project and attribute decls to every project header they include,
+    //headers no source includes are parsed on their own afterwards
+    //every source is compiled even if only a few headers are outdated, like after a change in watch mode,
+    //leave this off when the headers are included by few others and the sources outnumber them
+    bool sources = false;
+    //header that is precompiled once and implicitly included before every header, empty to disable
+    std::filesystem::path prelude;
+    //reuse the results of unchanged headers from the previous run
+    bool cache = false;
+    //stay resident and regenerate whenever a header changes
+    bool watch = false;
+    //skip headers without any code generator marker before running clang
+    bool prescan = true;
+    //only traverse the decls of each header itself and let clang skip function bodies
+    bool fastTraversal = false;
+    //register every Lua usertype in CreateBindings instead of the first time a script uses it
+    bool eagerLua = false;
+    //spread the generated bindings over this many .gen.cpp shards that can be compiled in parallel, 0 to disable
+    unsigned shards = 0;
+    //print the timings and counters of every run as a table
+    bool stats = false;
+    //write the timings and counters of every run as JSON to this file, "-" writes to stdout, empty to disable
+    //with "-" every other message is written to stderr
+    std::filesystem::path statsJson;
+};
+
+/// \brief the stages of a run, shared by the CodeGenerator executable and the benchmark
+class Pipeline {
+public:
+    /// \brief returns the arguments clang is run with for every header
+    static std::vector<std::string> GetCompileArguments();
+
+    /// \brief parses the provided headers and adds the results to ASTFileParser::GetParsers()
+    /// \param sources the sources of the project, only used in sources mode
+    /// \note the precompiled header is built first if a prelude is set and it has not been built yet
+    static void ExtractHeaders(const Options &options, SimpleOptionParser &optionParser,
+                               const std::vector<std::filesystem::path> &headers,
+                               const std::filesystem::path &output_directory,
+                               const std::vector<std::filesystem::path> &sources = {});
+
+    /// \brief runs the generators over all parsers and writes the generated files
+    /// \param headers the headers of the project, the parsers are sorted in this order first
+    static void GenerateFiles(const Options &options, const std::vector<std::filesystem::path> &headers);
+};
+
+#endif //CODEGENERATOR_PIPELINE_HPP
@@ -0,0 +1,74 @@
+#ifndef CODEGENERATOR_PROPERTYKEY_HPP
+#define CODEGENERATOR_PROPERTYKEY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+/// \brief an interned property name, comparing keys compares integers instead of strings
+/// \note names are interned once when properties are parsed, known names have a compile-time key in PropertyKeys
+class PropertyKey {
+    //0 is the key of the empty name, used for properties that were never interned
+    uint32_t id = 0;
+public:
+    constexpr PropertyKey() = default;
+
+    constexpr explicit PropertyKey(uint32_t id) : id(id) {};
+
+    /// \brief returns the key of the name, adding the name to the symbol table if it is new
+    /// \note thread safe, parsers on multiple threads intern names at the same time
+    static PropertyKey Intern(std::string_view name);
+
+    /// \brief returns the key of the name without adding it to the symbol table
+    /// \return the key, or the empty key if the name was never interned
+    static PropertyKey Find(std::string_view name);
+
+    /// \brief returns the interned name, the view stays valid for the lifetime of the program
+    [[nodiscard]] std::string_view GetName() const;
+
+    [[nodiscard]] constexpr uint32_t GetId() const {
+        return id;
+    };
+
+    [[nodiscard]] constexpr bool IsEmpty() const {
+        return id == 0;
+    };
+
+    constexpr bool operator==(const PropertyKey &other) const {
+        return id == other.id;
+    };
+
+    constexpr bool operator!=(const PropertyKey &other) const {
+        return id != other.id;
+    };
+
+    constexpr bool operator<(const PropertyKey &other) const {
+        return id < other.id;
+    };
+};
+
+/// \brief keys of the names used by the parser and the generators, these are interned before anything else
+/// \note the order must match the known names in PropertyKey.cpp
+namespace PropertyKeys {
+    inline constexpr PropertyKey CGClass{1};
+    inline constexpr PropertyKey CGMember{2};
+    inline constexpr PropertyKey CGMethod{3};
+    inline constexpr PropertyKey CGFunction{4};
+    inline constexpr PropertyKey CGVariable{5};
+    inline constexpr PropertyKey CGConstructor{6};
+    inline constexpr PropertyKey LuaClass{7};
+    inline constexpr PropertyKey LuaInspect{8};
+    inline constexpr PropertyKey CGEnum{9};
+    inline constexpr PropertyKey Serialize{10};
+    inline constexpr PropertyKey SoA{11};
+    inline constexpr PropertyKey Hashable{12};
+}
+
+template<>
+struct std::hash<PropertyKey> {
+    size_t operator()(const PropertyKey &key) const noexcept {
+        return key.GetId();
+    }
+};
+
+#endif //CODEGENERATOR_PROPERTYKEY_HPP
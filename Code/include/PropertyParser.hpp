@@ -0,0 +1,37 @@
+#ifndef CODEGENERATOR_PROPERTYPARSER_HPP
+#define CODEGENERATOR_PROPERTYPARSER_HPP
+
+#include "Objects.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// \brief parses the property lists of markers and annotations in a single pass
+/// \note the grammar of a list is:
+/// \note list     = [property {"," property} [","]]
+/// \note property = name ["=" value]
+/// \note name     = word | string
+/// \note value    = word | string | "{" list "}"
+/// \note a word is a run of letters, digits, and _ : . + - which covers identifiers, qualified names, and numbers,
+/// \note a string is enclosed in double quotes and may contain \" \\ \n and \t escapes, whitespace between tokens is ignored
+/// \code CGCLASS(LuaClass, Name="Some name", Size=1.5, Flags={Serialize, Version=2}) \endcode
+class PropertyParser {
+public:
+    struct Error {
+        //position in the parsed text
+        size_t position;
+        std::string message;
+    };
+
+    /// \brief parses a list of properties
+    /// \param text the list to parse, parsing stops at the end of the text or at a ')' outside of strings and lists
+    /// \param properties the parsed properties are appended to this vector, properties before an error are kept
+    /// \param end receives the position parsing stopped at, either the size of text or the position of the ')'
+    /// \return the error if the list is invalid, nullopt otherwise
+    /// \note properties without a value get an empty string as value
+    static std::optional<Error> Parse(std::string_view text, std::vector<Property> &properties, size_t *end = nullptr);
+};
+
+#endif //CODEGENERATOR_PROPERTYPARSER_HPP
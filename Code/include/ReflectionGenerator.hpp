@@ -0,0 +1,24 @@
+#ifndef CODEGENERATOR_REFLECTIONGENERATOR_HPP
+#define CODEGENERATOR_REFLECTIONGENERATOR_HPP
+
+#include "FileGenerator.hpp"
+#include "Objects.hpp"
+
+#include <string>
+
+/// \brief generates Reflection/<class>.gen.hpp for every class, a constexpr table of its public annotated members
+/// \note bit-fields, and all members of classes with virtual bases, have no offset and are left out
+/// \note the tables specialize CodeGenerator::Reflection from the runtime header CodeGenerator/Reflection.hpp,
+/// \note so CodeGenerator::Reflect<T>() iterates the members without allocating or hashing
+/// \note every CGENUM gets a Reflection/<enum>.gen.hpp as well, specializing CodeGenerator::EnumReflection
+class ReflectionGenerator {
+public:
+    static void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+
+    static void HandleEnum(FileGenerator &fileGenerator, const Enum &enum_);
+
+    /// \brief returns the name of the generated file for the class or enum, relative to the output directory
+    static std::string GetFileName(const Object &object);
+};
+
+#endif //CODEGENERATOR_REFLECTIONGENERATOR_HPP
@@ -0,0 +1,20 @@
+#ifndef CODEGENERATOR_SERIALIZATIONGENERATOR_HPP
+#define CODEGENERATOR_SERIALIZATIONGENERATOR_HPP
+
+#include "FileGenerator.hpp"
+#include "Objects.hpp"
+
+#include <string>
+
+/// \brief generates Serialization/<class>.gen.hpp for every class with the Serialize property
+/// \note the files specialize CodeGenerator::Serializer from the runtime header CodeGenerator/Serialization.hpp,
+/// \note consecutive trivially copyable members are written with a single copy, other members one by one
+class SerializationGenerator {
+public:
+    static void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+
+    /// \brief returns the name of the generated file for the class, relative to the output directory
+    static std::string GetFileName(const Object &object);
+};
+
+#endif //CODEGENERATOR_SERIALIZATIONGENERATOR_HPP
@@ -4,6 +4,7 @@
 #include <clang/Tooling/CompilationDatabase.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <filesystem>
 
@@ -12,6 +13,11 @@ class SimpleOptionParser : public clang::tooling::CompilationDatabase {
     std::vector<std::filesystem::path> headers;
     std::filesystem::path output_directory;
     std::filesystem::path input_directory;
+    std::filesystem::path precompiled_header;
+    std::vector<std::string> precompiled_header_inputs;
+    
+    /// \brief returns the arguments for a single file, including the precompiled header if one is set
+    [[nodiscard]] std::vector<std::string> GetArguments(const std::string& file) const;
 public:
     SimpleOptionParser() = default;
     explicit SimpleOptionParser(const std::vector<std::string>& args, const std::vector<std::filesystem::path>& headers);
@@ -19,8 +25,38 @@ public:
     void SetOutputDirectory(const std::filesystem::path& output_directory);
     void SetInputDirectory(const std::filesystem::path& input_directory);
     
+    /// \brief replaces the headers that compile commands are created for
+    /// \param headers the headers to parse
+    void SetHeaders(const std::vector<std::filesystem::path>& headers);
+    
+    /// \brief injects the precompiled header into the arguments of every file
+    /// \param precompiled_header path to the precompiled header, an empty path disables it again
+    /// \param inputs normalized paths of the files the precompiled header was built from
+    /// \note the precompiled header must be built with the same arguments, see ToolRunner::BuildPrecompiledHeader
+    void SetPrecompiledHeader(const std::filesystem::path& precompiled_header, std::vector<std::string> inputs = {});
+    [[nodiscard]] const std::filesystem::path& GetPrecompiledHeader() const;
+    
+    /// \brief returns the files the precompiled header was built from, a change to any of them makes it outdated
+    [[nodiscard]] const std::vector<std::string>& GetPrecompiledHeaderInputs() const;
+    
+    /// \brief creates the in-memory sources for unity mode, each source includes a share of the headers
+    /// \param count the amount of unity sources to split the headers over
+    /// \return pairs of (absolute path, source) for each unity source, the paths are placed in the output directory
+    /// \note the headers are included by their exact path so ASTFileParser can attribute decls to them
+    [[nodiscard]] std::vector<std::pair<std::string, std::string>> GetUnitySources(size_t count) const;
+    
     [[nodiscard]] std::vector<clang::tooling::CompileCommand> getAllCompileCommands() const override;
     [[nodiscard]] std::vector<std::string> getAllFiles() const override;
+    
+    /// \brief removes the headers that don't contain any code generator marker, these don't have to be parsed
+    /// \return the amount of headers that were removed
+    /// \note markers and annotations are both written in the source, so a header without marker text never produces output
+    size_t PruneUnannotatedHeaders();
+    
+    /// \brief tests if the file contains any code generator marker (CGCLASS, CGMEMBER, CGENUM, ...) or cg: annotation
+    /// \param file the file to scan
+    /// \return true if a marker was found or the file could not be read
+    static bool HasMarkers(const std::filesystem::path& file);
     [[nodiscard]] std::vector<clang::tooling::CompileCommand> getCompileCommands(llvm::StringRef FilePath) const override;
 };
 
@@ -0,0 +1,20 @@
+#ifndef CODEGENERATOR_SOAGENERATOR_HPP
+#define CODEGENERATOR_SOAGENERATOR_HPP
+
+#include "FileGenerator.hpp"
+#include "Objects.hpp"
+
+#include <string>
+
+/// \brief generates SoA/<class>.gen.hpp for every class with the SoA property, a structure of arrays container
+/// \note the files specialize CodeGenerator::SoA from the runtime header CodeGenerator/SoA.hpp,
+/// \note every annotated member gets its own aligned column, so loops over a single member can be vectorized
+class SoAGenerator {
+public:
+    static void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+
+    /// \brief returns the name of the generated file for the class, relative to the output directory
+    static std::string GetFileName(const Object &object);
+};
+
+#endif //CODEGENERATOR_SOAGENERATOR_HPP
@@ -0,0 +1,92 @@
+#ifndef CODEGENERATOR_STATISTICS_HPP
+#define CODEGENERATOR_STATISTICS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// \brief collects the timings and counters of a run
+/// \note all functions are thread safe, files are parsed on multiple threads when using --jobs
+class Statistics {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = Clock::duration;
+
+    enum class Phase : size_t {
+        //loading the project with XmlParser
+        LoadProject,
+        //clang preprocessing, parsing, and semantic analysis, summed over all files
+        Parse,
+        //ASTFileParser traversal, summed over all files
+        Traverse,
+        //FileGenerator::Parse and the callbacks it calls
+        Generate,
+        //FileGenerator::WriteFiles
+        Write,
+        //the whole run
+        Total,
+        Count
+    };
+
+    struct Counters {
+        uint64_t declsVisited = 0;
+        uint64_t declsSkipped = 0;
+        //skipped decls rejected by comparing their FileID alone, without looking up their file
+        uint64_t declsSkippedByFileID = 0;
+        uint64_t annotatedEntities = 0;
+        uint64_t skippedParameters = 0;
+    };
+
+    /// \brief adds the time between construction and destruction to a phase
+    class ScopedTimer {
+        Phase phase;
+        Clock::time_point start;
+    public:
+        explicit ScopedTimer(Phase phase) : phase(phase), start(Clock::now()) {};
+
+        ~ScopedTimer() {
+            AddTime(phase, Clock::now() - start);
+        };
+    };
+
+    static void AddTime(Phase phase, Duration duration);
+
+    /// \brief adds the timings of a single file passed to clang
+    /// \param file the file that was parsed
+    /// \param parse time spent in clang, not including the traversal
+    /// \param traverse time spent traversing the AST
+    static void AddFile(const std::string &file, Duration parse, Duration traverse);
+
+    static void AddCounters(const Counters &counters);
+
+    [[nodiscard]] static Duration GetTime(Phase phase);
+
+    [[nodiscard]] static Counters GetCounters();
+
+    /// \brief clears all timings and counters, used between runs in watch mode
+    static void Reset();
+
+    /// \brief prints the phases, counters, and slowest files as a table
+    static void PrintTable(std::ostream &output);
+
+    /// \brief writes all timings and counters as JSON, including the timing of every file
+    static void WriteJson(std::ostream &output);
+
+private:
+    struct FileTiming {
+        std::string file;
+        Duration parse;
+        Duration traverse;
+    };
+
+    static std::mutex mutex;
+    static std::array<Duration, static_cast<size_t>(Phase::Count)> phases;
+    static Counters counters;
+    static std::vector<FileTiming> files;
+};
+
+#endif //CODEGENERATOR_STATISTICS_HPP
@@ -0,0 +1,46 @@
+#ifndef CODEGENERATOR_TOOLRUNNER_HPP
+#define CODEGENERATOR_TOOLRUNNER_HPP
+
+#include <clang/Tooling/CompilationDatabase.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// \brief runs the ASTFrontendAction over a list of files, optionally spread over multiple threads
+class ToolRunner {
+public:
+    /// \brief parses all provided files and stores the results in ASTFileParser::GetParsers()
+    /// \param database the compilation database to get the arguments for each file from
+    /// \param files the files to parse
+    /// \param jobs the amount of threads to use, 0 will use one thread per core
+    /// \param virtualFiles pairs of (path, content) that are mapped into the file system of every tool
+    /// \return 0 on success, the highest ClangTool error code otherwise
+    /// \note the resulting parsers are sorted to match the order of files, regardless of the amount of jobs
+    static int Run(const clang::tooling::CompilationDatabase &database, const std::vector<std::string> &files,
+                   unsigned jobs = 1, const std::vector<std::pair<std::string, std::string>> &virtualFiles = {});
+    
+    /// \brief resolves the amount of threads that will be used for the provided amount of jobs
+    /// \param jobs the requested amount of jobs, 0 will use one thread per core
+    /// \return the amount of threads, at least 1
+    static unsigned GetJobCount(unsigned jobs);
+    
+    /// \brief keeps the status of files between runs, files in the volatile directories are never cached
+    /// \param volatileDirectories directories with files that may change between runs, usually the project directories
+    /// \note used by watch mode, the standard library headers only have to be looked up once per process
+    static void EnableStatCache(const std::vector<std::filesystem::path> &volatileDirectories);
+    
+    /// \brief builds a precompiled header from the provided prelude header
+    /// \param database the compilation database to get the arguments for the prelude from
+    /// \param prelude the header to precompile
+    /// \param output the path to write the precompiled header to
+    /// \param inputs set to the normalized paths of every file the precompiled header contains, the prelude included
+    /// \return 0 on success, the ClangTool error code otherwise
+    /// \note the database should not inject the precompiled header yet, otherwise it will try to include itself
+    static int BuildPrecompiledHeader(const clang::tooling::CompilationDatabase &database,
+                                      const std::filesystem::path &prelude, const std::filesystem::path &output,
+                                      std::vector<std::string> &inputs);
+};
+
+#endif //CODEGENERATOR_TOOLRUNNER_HPP
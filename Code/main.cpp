@@ -1,32 +1,66 @@
 #include <clang/Tooling/Tooling.h>
 #include <clang/Frontend/CompilerInstance.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_set>
 
 #include "XmlParser.hpp"
 #include "FileParser.hpp"
 #include "SimpleOptionParser.hpp"
 #include "FileGenerator.hpp"
+#include "ToolRunner.hpp"
+#include "ExtractionCache.hpp"
+#include "FileWatcher.hpp"
+#include "Pipeline.hpp"
+#include "Statistics.hpp"
 
-void HandleClass(FileGenerator &fileGenerator, const Class &class_);
+//stdout of the process, std::cout is redirected to stderr while the statistics are written to stdout as JSON
+std::streambuf *const standardOutput = std::cout.rdbuf();
 
-void HandleMember(FileGenerator &fileGenerator, const Variable &variable);
+/// \brief parses the optional command line arguments
+/// \param options the options to fill
+/// \return true if all arguments were valid, false otherwise
+bool ParseOptions(int argc, char *argv[], Options &options);
 
-void HandleMethod(FileGenerator &fileGenerator, const Function &function);
+/// \brief true if the prelude or one of the files it includes changed, so the precompiled header is outdated
+bool PreludeChanged(const Options &options, const SimpleOptionParser &optionParser,
+                    const std::unordered_set<std::string> &changed);
+
+/// \brief adds the total time of the run and reports the statistics as requested by the options
+/// \param start the moment the run started
+void ReportStatistics(const Options &options, Statistics::Clock::time_point start);
+
+/// \brief returns the directories that contain the solution file, the headers, and the prelude
+std::vector<std::filesystem::path> GetWatchedDirectories(const std::filesystem::path &solution_file,
+                                                         const std::vector<std::filesystem::path> &headers,
+                                                         const Options &options);
 
 int main(int argc, char *argv[]) {
     //argc = 3;
 
-    //run the program 1000 times to get a good average
-    //for (int i = 0; i < 1000; ++i) 
+    //repeated runs for benchmarking are done by CodeGeneratorBench
     {
 
         if (argc < 3) {
-            std::cout << "Usage: " << argv[0] << " <solution file> <output directory>" << std::endl;
+            std::cout << "Usage: " << argv[0] << " <solution file> <output directory> [--jobs N] [--unity] [--sources] [--prelude <header>] [--cache] [--watch] [--no-prescan] [--fast-traversal] [--eager-lua] [--shards N] [--stats] [--stats-json <file>]" << std::endl;
             return 1;
         }
 
+        Options options{};
+        if (!ParseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        //the JSON has to be the only output on stdout, so it can be piped into other tools
+        if (options.statsJson == "-") {
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+
         std::cout << "Solution file: " << argv[1] << std::endl;
         const std::filesystem::path solution_file{argv[1]};
         if (!exists(solution_file) || solution_file.extension() != ".vcxproj") {
@@ -41,97 +75,269 @@ int main(int argc, char *argv[]) {
             return -1;
         }
 
-        XmlParser xmlParser{solution_file};
-        const auto headers = xmlParser.GetAllHeaders();
-
-        //construct command line arguments for clang
-        //TODO: make this dynamic, for now they will be hard coded
-        std::vector<std::string> args{};
-        //clang should work on all files in the headers vector
-        //clang should only create the AST, not compile the files
-        //clang should only care about the provided headers
-        //clang should only care about definitions, not function bodies
-        //clang should use the C++17 standard
-        args.emplace_back("clang");
-        args.emplace_back("-fsyntax-only");
-        args.emplace_back("-std=c++17");
-        args.emplace_back("-IC:/Program Files/Microsoft Visual Studio/2022/Community/VC/Tools/MSVC/14.38.33130/include");
+        auto start = Statistics::Clock::now();
+
+        std::optional<XmlParser> xmlParser{};
+        std::vector<std::filesystem::path> headers{};
+        std::vector<std::filesystem::path> sources{};
+        {
+            Statistics::ScopedTimer timer{Statistics::Phase::LoadProject};
+            xmlParser.emplace(solution_file);
+            headers = xmlParser->GetAllHeaders();
+            if (options.sources) {
+                sources = xmlParser->GetAllSources();
+            }
+        }
+
+        const auto args = Pipeline::GetCompileArguments();
 
         //create a compile database
         SimpleOptionParser optionParser{args, headers};
         optionParser.SetOutputDirectory(output_directory);
-        optionParser.SetInputDirectory(xmlParser.GetDirectoryRoot());
+        optionParser.SetInputDirectory(xmlParser->GetDirectoryRoot());
 
-        clang::tooling::ClangTool tool{optionParser, optionParser.getAllFiles()};
+        ASTFileParser::SetProjectHeaders(headers);
+        ASTFileParser::SetFastTraversal(options.fastTraversal);
+        FileGenerator::output_directory = output_directory;
 
-        //reserve space for the FileParser
-        ASTFileParser::Reserve(headers.size());
+        //the standard library doesn't change while watching, keep its file status between runs
+        if (options.watch) {
+            ToolRunner::EnableStatCache(GetWatchedDirectories(solution_file, headers, options));
+        }
 
-        //run the tool
-        tool.run(clang::tooling::newFrontendActionFactory<ASTFrontendAction>().get());
+        //load the unchanged headers from the cache, only the remaining headers have to be parsed
+        auto outdatedHeaders = headers;
+        std::optional<ExtractionCache> cache{};
+        if (options.cache) {
+            cache.emplace(output_directory / "CodeGenerator.cache.xml", args, options.prelude);
+            outdatedHeaders = cache->Load(headers);
+        }
 
-        FileGenerator File{};
-        FileGenerator::output_directory = output_directory;
+        Pipeline::ExtractHeaders(options, optionParser, outdatedHeaders, output_directory, sources);
+
+        if (cache) {
+            //the precompiled header is only built when headers are parsed, otherwise the inputs of the last run are kept
+            if (!optionParser.GetPrecompiledHeaderInputs().empty()) {
+                cache->SetPreludeInputs(optionParser.GetPrecompiledHeaderInputs());
+            }
+            cache->Save(ASTFileParser::GetParsers());
+        }
 
-        File.ParseClass = HandleClass;
-        File.ParseMember = HandleMember;
-        File.ParseMethod = HandleMethod;
+        Pipeline::GenerateFiles(options, headers);
+        ReportStatistics(options, start);
 
-        for (const auto &parser: ASTFileParser::GetParsers()) {
-            File.Parse(parser);
+        if (!options.watch) {
+            return 0;
         }
 
-        FileGenerator::WriteFiles();
+        std::optional<FileWatcher> watcher{};
+        watcher.emplace(GetWatchedDirectories(solution_file, headers, options));
+
+        while (true) {
+            std::cout << "Watching for changes..." << std::endl;
+
+            std::unordered_set<std::string> changed{};
+            for (const auto &change: watcher->Wait()) {
+                changed.emplace(ASTFileParser::NormalizePath(change));
+            }
+
+            //every regeneration is reported on its own
+            Statistics::Reset();
+            start = Statistics::Clock::now();
+
+            if (cache) {
+                cache->Invalidate(changed);
+            }
+
+            std::vector<std::filesystem::path> outdated{};
+
+            if (changed.count(ASTFileParser::NormalizePath(solution_file)) != 0) {
+                //the headers of the project may have changed, start over with the new list of headers
+                std::cout << "Project changed, reloading " << solution_file << std::endl;
+
+                {
+                    Statistics::ScopedTimer timer{Statistics::Phase::LoadProject};
+                    xmlParser.emplace(solution_file);
+                    headers = xmlParser->GetAllHeaders();
+                    if (options.sources) {
+                        sources = xmlParser->GetAllSources();
+                    }
+                }
+                ASTFileParser::SetProjectHeaders(headers);
+                ASTFileParser::ClearParsers();
+
+                outdated = cache ? cache->Load(headers) : headers;
+
+                //the stat cache has to treat the directories of new headers as volatile as well
+                const auto directories = GetWatchedDirectories(solution_file, headers, options);
+                ToolRunner::EnableStatCache(directories);
+                watcher.emplace(directories);
+            } else if (PreludeChanged(options, optionParser, changed)) {
+                //every header depends on the precompiled header, rebuild it and parse everything again
+                optionParser.SetPrecompiledHeader({});
+                ASTFileParser::ClearParsers();
+                outdated = headers;
+            } else {
+                //headers that changed themselves, or include a header that changed
+                std::unordered_set<std::string> affected{};
+                for (const auto &parser: ASTFileParser::GetParsers()) {
+                    for (const auto &dependency: parser.GetDependencies()) {
+                        if (changed.count(dependency) != 0) {
+                            affected.emplace(ASTFileParser::NormalizePath(parser.GetPath()));
+                            break;
+                        }
+                    }
+                }
 
+                for (const auto &header: headers) {
+                    const auto normalized = ASTFileParser::NormalizePath(header);
+                    if (changed.count(normalized) != 0 || affected.count(normalized) != 0) {
+                        outdated.emplace_back(header);
+                        affected.emplace(normalized);
+                    }
+                }
+
+                ASTFileParser::RemoveParsers(affected);
+                if (cache) {
+                    cache->Invalidate(affected);
+                }
+            }
+
+            if (outdated.empty()) {
+                continue;
+            }
+
+            std::cout << "Regenerating " << outdated.size() << " headers" << std::endl;
+
+            Pipeline::ExtractHeaders(options, optionParser, outdated, output_directory, sources);
+
+            if (cache) {
+                if (!optionParser.GetPrecompiledHeaderInputs().empty()) {
+                    cache->SetPreludeInputs(optionParser.GetPrecompiledHeaderInputs());
+                }
+                cache->Save(ASTFileParser::GetParsers());
+            }
+
+            Pipeline::GenerateFiles(options, headers);
+            ReportStatistics(options, start);
+        }
     }
     return 0;
 }
 
-const Class *currentClass = nullptr;
+bool PreludeChanged(const Options &options, const SimpleOptionParser &optionParser,
+                    const std::unordered_set<std::string> &changed) {
+    if (options.prelude.empty()) {
+        return false;
+    }
+    if (changed.count(ASTFileParser::NormalizePath(options.prelude)) != 0) {
+        return true;
+    }
+
+    //only the inputs in the watched directories are reported, the standard library is expected to stay the same
+    const auto &inputs = optionParser.GetPrecompiledHeaderInputs();
+    return std::any_of(inputs.begin(), inputs.end(), [&changed](const auto &input) {
+        return changed.count(ASTFileParser::NormalizePath(input)) != 0;
+    });
+}
+
+void ReportStatistics(const Options &options, Statistics::Clock::time_point start) {
+    Statistics::AddTime(Statistics::Phase::Total, Statistics::Clock::now() - start);
 
-void HandleClass(FileGenerator &fileGenerator, const Class &class_) {
-    currentClass = &class_;
+    if (options.stats) {
+        Statistics::PrintTable(std::cout);
+    }
 
-    auto &properties = class_.properties;
-    if (FileGenerator::GetProperty(properties, "LuaClass") != nullptr) {
-        FileGenerator::files["LuaBindings.cpp.gen"].includes.insert(class_.path);
-        auto &function = FileGenerator::files["LuaBindings.cpp.gen"].functions["CreateBindings"];
-        function.header.AddVariable({"sol::state&", "lua_state"});
+    if (options.statsJson.empty()) {
+        return;
+    }
 
-        auto &body = function.body;
-        std::string userTypeCreation =
-                "sol::usertype<" + class_.fullNamespace + "> " + class_.name + "_table = lua_state.new_usertype<" +
-                class_.fullNamespace + ">(\"" + class_.name + "\", sol::constructors<" + class_.fullNamespace +
-                "()>{});";
+    if (options.statsJson == "-") {
+        std::ostream output{standardOutput};
+        Statistics::WriteJson(output);
+        output.flush();
+        return;
+    }
 
-        body.emplace_back(userTypeCreation);
+    std::ofstream output{options.statsJson};
+    if (!output) {
+        std::cerr << "Error: could not write statistics to " << options.statsJson << std::endl;
+        return;
     }
+    Statistics::WriteJson(output);
 }
 
-void HandleMember(FileGenerator &fileGenerator, const Variable &variable) {
-    auto &properties = variable.properties;
-    if (FileGenerator::GetProperty(properties, "LuaInspect") != nullptr) {
-        FileGenerator::files["LuaBindings.cpp.gen"].includes.insert(variable.path);
-        auto &function = FileGenerator::files["LuaBindings.cpp.gen"].functions["CreateBindings"];
-        function.header.AddVariable({"sol::state&", "lua_state"});
-
-        auto &body = function.body;
-        std::string propertyCreation =
-                currentClass->name + "_table[\"" + variable.name + "\"] = &" + variable.fullNamespace + ";";
-        body.emplace_back(propertyCreation);
+std::vector<std::filesystem::path> GetWatchedDirectories(const std::filesystem::path &solution_file,
+                                                         const std::vector<std::filesystem::path> &headers,
+                                                         const Options &options) {
+    std::unordered_set<std::string> unique{};
+    std::vector<std::filesystem::path> directories{};
+
+    const auto add = [&unique, &directories](const std::filesystem::path &file) {
+        const auto directory = std::filesystem::path{ASTFileParser::NormalizePath(file)}.parent_path();
+        if (unique.insert(directory.string()).second) {
+            directories.emplace_back(directory);
+        }
+    };
+
+    add(solution_file);
+    for (const auto &header: headers) {
+        add(header);
     }
+    if (!options.prelude.empty()) {
+        add(options.prelude);
+    }
+
+    return directories;
 }
 
-void HandleMethod(FileGenerator &fileGenerator, const Function &function) {
-    auto &properties = function.properties;
-    if (FileGenerator::GetProperty(properties, "LuaInspect") != nullptr) {
-        FileGenerator::files["LuaBindings.cpp.gen"].includes.insert(function.path);
-        auto &fullFunction = FileGenerator::files["LuaBindings.cpp.gen"].functions["CreateBindings"];
-        fullFunction.header.AddVariable({"sol::state&", "lua_state"});
-
-        auto &body = fullFunction.body;
-        std::string propertyCreation =
-                currentClass->name + "_table[\"" + function.name + "\"] = &" + function.fullNamespace + "();";
-        body.emplace_back(propertyCreation);
+bool ParseOptions(int argc, char *argv[], Options &options) {
+    for (int i = 3; i < argc; ++i) {
+        const std::string argument{argv[i]};
+
+        if ((argument == "--jobs" || argument == "-j") && i + 1 < argc) {
+            try {
+                options.jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+            } catch (const std::exception &) {
+                std::cerr << "Error: " << argv[i] << " is not a valid amount of jobs" << std::endl;
+                return false;
+            }
+        } else if (argument == "--unity") {
+            options.unity = true;
+        } else if (argument == "--sources") {
+            options.sources = true;
+        } else if (argument == "--prelude" && i + 1 < argc) {
+            options.prelude = argv[++i];
+            if (!exists(options.prelude)) {
+                std::cerr << "Error: " << options.prelude << " does not exist" << std::endl;
+                return false;
+            }
+        } else if (argument == "--cache") {
+            options.cache = true;
+        } else if (argument == "--watch") {
+            options.watch = true;
+        } else if (argument == "--no-prescan") {
+            options.prescan = false;
+        } else if (argument == "--fast-traversal") {
+            options.fastTraversal = true;
+        } else if (argument == "--eager-lua") {
+            options.eagerLua = true;
+        } else if (argument == "--shards" && i + 1 < argc) {
+            try {
+                options.shards = static_cast<unsigned>(std::stoul(argv[++i]));
+            } catch (const std::exception &) {
+                std::cerr << "Error: " << argv[i] << " is not a valid amount of shards" << std::endl;
+                return false;
+            }
+        } else if (argument == "--stats") {
+            options.stats = true;
+        } else if (argument == "--stats-json" && i + 1 < argc) {
+            options.statsJson = argv[++i];
+        } else {
+            std::cerr << "Error: unknown argument " << argument << std::endl;
+            return false;
+        }
     }
-}
\ No newline at end of file
+
+    return true;
+}
@@ -0,0 +1,357 @@
+#include "ExtractionCache.hpp"
+
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/xxhash.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    uint64_t CombineHashes(uint64_t a, uint64_t b) {
+        return a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+    }
+
+    //a property either has a value attribute, or a child node for every property in its list
+    void WriteProperties(pugi::xml_node node, const std::vector<Property> &properties) {
+        for (const auto &property: properties) {
+            auto child = node.append_child("Property");
+            child.append_attribute("name") = property.name.c_str();
+
+            if (const auto *value = std::get_if<std::string>(&property.value)) {
+                child.append_attribute("value") = value->c_str();
+            } else {
+                WriteProperties(child, std::get<std::vector<Property>>(property.value));
+            }
+        }
+    }
+
+    std::vector<Property> ReadProperties(const pugi::xml_node &node) {
+        std::vector<Property> properties{};
+        for (const auto &child: node.children("Property")) {
+            auto &property = properties.emplace_back();
+            property.name = child.attribute("name").as_string();
+            property.key = PropertyKey::Intern(property.name);
+
+            if (const auto value = child.attribute("value")) {
+                property.value = std::string{value.as_string()};
+            } else {
+                property.value = ReadProperties(child);
+            }
+        }
+        return properties;
+    }
+
+    void WriteObject(pugi::xml_node node, const Object &object) {
+        node.append_attribute("name") = object.name.c_str();
+        node.append_attribute("fullNamespace") = object.fullNamespace.c_str();
+        node.append_attribute("path") = object.path.string().c_str();
+        node.append_attribute("usr") = object.usr.c_str();
+        WriteProperties(node, object.properties);
+    }
+
+    void ReadObject(const pugi::xml_node &node, Object &object) {
+        object.name = node.attribute("name").as_string();
+        object.fullNamespace = node.attribute("fullNamespace").as_string();
+        object.path = node.attribute("path").as_string();
+        object.usr = node.attribute("usr").as_string();
+        object.SetProperties(ReadProperties(node));
+    }
+
+    void WriteVariable(pugi::xml_node node, const Variable &variable) {
+        WriteObject(node, variable);
+        node.append_attribute("type") = variable.type.c_str();
+        node.append_attribute("isTriviallyCopyable") = variable.isTriviallyCopyable;
+        node.append_attribute("isBitField") = variable.isBitField;
+        node.append_attribute("isArray") = variable.isArray;
+        node.append_attribute("isReference") = variable.isReference;
+        node.append_attribute("isConst") = variable.isConst;
+        node.append_attribute("fieldIndex") = variable.fieldIndex;
+        node.append_attribute("isPublic") = variable.isPublic;
+    }
+
+    Variable ReadVariable(const pugi::xml_node &node) {
+        Variable variable{};
+        ReadObject(node, variable);
+        variable.type = node.attribute("type").as_string();
+        variable.isTriviallyCopyable = node.attribute("isTriviallyCopyable").as_bool();
+        variable.isBitField = node.attribute("isBitField").as_bool();
+        variable.isArray = node.attribute("isArray").as_bool();
+        variable.isReference = node.attribute("isReference").as_bool();
+        variable.isConst = node.attribute("isConst").as_bool();
+        variable.fieldIndex = node.attribute("fieldIndex").as_uint();
+        variable.isPublic = node.attribute("isPublic").as_bool(true);
+        return variable;
+    }
+
+    void WriteFunction(pugi::xml_node node, const Function &function) {
+        WriteObject(node, function);
+        node.append_attribute("returnType") = function.returnType.c_str();
+        node.append_attribute("isConstructor") = function.isConstruptor;
+
+        for (const auto &parameter: function.parameters) {
+            WriteVariable(node.append_child("Parameter"), parameter);
+        }
+    }
+
+    Function ReadFunction(const pugi::xml_node &node) {
+        Function function{};
+        ReadObject(node, function);
+        function.returnType = node.attribute("returnType").as_string();
+        function.isConstruptor = node.attribute("isConstructor").as_bool();
+
+        for (const auto &parameter: node.children("Parameter")) {
+            function.parameters.emplace_back(ReadVariable(parameter));
+        }
+        return function;
+    }
+
+    void WriteEnum(pugi::xml_node node, const Enum &enum_) {
+        WriteObject(node, enum_);
+        node.append_attribute("underlyingType") = enum_.underlyingType.c_str();
+        node.append_attribute("isScoped") = enum_.isScoped;
+
+        for (const auto &enumerator: enum_.enumerators) {
+            auto child = node.append_child("Enumerator");
+            WriteObject(child, enumerator);
+            child.append_attribute("value") = static_cast<long long>(enumerator.value);
+        }
+    }
+
+    Enum ReadEnum(const pugi::xml_node &node) {
+        Enum enum_{};
+        ReadObject(node, enum_);
+        enum_.underlyingType = node.attribute("underlyingType").as_string();
+        enum_.isScoped = node.attribute("isScoped").as_bool();
+
+        for (const auto &child: node.children("Enumerator")) {
+            auto &enumerator = enum_.enumerators.emplace_back();
+            ReadObject(child, enumerator);
+            enumerator.value = child.attribute("value").as_llong();
+        }
+        return enum_;
+    }
+
+    void WriteClass(pugi::xml_node node, const Class &class_) {
+        WriteObject(node, class_);
+        node.append_attribute("enclosingNamespace") = class_.enclosingNamespace.c_str();
+        node.append_attribute("isStandardLayout") = class_.isStandardLayout;
+        node.append_attribute("hasVirtualBases") = class_.hasVirtualBases;
+
+        for (const auto &variable: class_.variables) {
+            WriteVariable(node.append_child("Variable"), variable);
+        }
+        for (const auto &function: class_.functions) {
+            WriteFunction(node.append_child("Function"), function);
+        }
+    }
+
+    Class ReadClass(const pugi::xml_node &node) {
+        Class class_{};
+        ReadObject(node, class_);
+        class_.enclosingNamespace = node.attribute("enclosingNamespace").as_string();
+        class_.isStandardLayout = node.attribute("isStandardLayout").as_bool(true);
+        class_.hasVirtualBases = node.attribute("hasVirtualBases").as_bool();
+
+        for (const auto &variable: node.children("Variable")) {
+            class_.variables.emplace_back(ReadVariable(variable));
+        }
+        for (const auto &function: node.children("Function")) {
+            class_.functions.emplace_back(ReadFunction(function));
+        }
+        return class_;
+    }
+}
+
+ExtractionCache::ExtractionCache(std::filesystem::path file, const std::vector<std::string> &args,
+                                 const std::filesystem::path &prelude) : file(std::move(file)), prelude(prelude) {
+    //separate the arguments with a null character, so {"ab", "c"} and {"a", "bc"} hash differently
+    std::string joined{};
+    for (const auto &arg: args) {
+        joined += arg;
+        joined += '\0';
+    }
+    compileHash = llvm::xxHash64(joined);
+    UpdateArgumentsHash();
+}
+
+void ExtractionCache::UpdateArgumentsHash() {
+    argumentsHash = compileHash;
+    if (prelude.empty()) {
+        return;
+    }
+
+    //the precompiled header is not part of the arguments, but its content affects every header,
+    //until its inputs are known from a previous run or from building it, only the prelude itself is hashed
+    argumentsHash = CombineHashes(argumentsHash, HashFile(ASTFileParser::NormalizePath(prelude)));
+    for (const auto &input: preludeInputs) {
+        argumentsHash = CombineHashes(argumentsHash, HashFile(input));
+    }
+}
+
+uint64_t ExtractionCache::HashFile(const std::string &path) {
+    const auto it = fileHashes.find(path);
+    if (it != fileHashes.end()) {
+        return it->second;
+    }
+
+    uint64_t hash = 0;
+    if (auto buffer = llvm::MemoryBuffer::getFile(path)) {
+        hash = llvm::xxHash64((*buffer)->getBuffer());
+    }
+
+    fileHashes.emplace(path, hash);
+    return hash;
+}
+
+uint64_t ExtractionCache::GetKey(const std::string &header) {
+    return CombineHashes(HashFile(header), argumentsHash);
+}
+
+bool ExtractionCache::IsValid(const pugi::xml_node &entry, const std::string &header) {
+    if (entry.attribute("key").as_ullong() != GetKey(header)) {
+        return false;
+    }
+
+    for (const auto &dependency: entry.children("Dependency")) {
+        if (dependency.attribute("hash").as_ullong() != HashFile(dependency.attribute("path").as_string())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<std::filesystem::path> ExtractionCache::Load(const std::vector<std::filesystem::path> &headers) {
+    entries.clear();
+    reused.clear();
+
+    if (std::filesystem::exists(file)) {
+        const auto result = document.load_file(file.c_str());
+        if (!result || document.child("CodeGeneratorCache").attribute("version").as_uint() != version) {
+            std::cout << "Discarding outdated cache: " << file << std::endl;
+            document.reset();
+        }
+    }
+
+    preludeInputs.clear();
+    for (const auto &input: document.child("CodeGeneratorCache").child("Prelude").children("Input")) {
+        preludeInputs.emplace_back(input.attribute("path").as_string());
+    }
+    UpdateArgumentsHash();
+
+    for (const auto &entry: document.child("CodeGeneratorCache").children("Header")) {
+        entries.emplace(entry.attribute("header").as_string(), entry);
+    }
+
+    std::vector<std::filesystem::path> outdated{};
+    for (const auto &header: headers) {
+        const auto normalized = ASTFileParser::NormalizePath(header);
+
+        const auto it = entries.find(normalized);
+        if (it == entries.end() || !IsValid(it->second, normalized)) {
+            outdated.emplace_back(header);
+            continue;
+        }
+
+        const auto &entry = it->second;
+        ASTFileParser parser{entry.attribute("path").as_string()};
+
+        for (const auto &dependency: entry.children("Dependency")) {
+            parser.dependencies.emplace_back(dependency.attribute("path").as_string());
+        }
+        for (const auto &class_: entry.children("Class")) {
+            parser.classes.emplace_back(ReadClass(class_));
+        }
+        for (const auto &function: entry.children("Function")) {
+            parser.functions.emplace_back(ReadFunction(function));
+        }
+        for (const auto &variable: entry.children("Variable")) {
+            parser.variables.emplace_back(ReadVariable(variable));
+        }
+        for (const auto &enum_: entry.children("Enum")) {
+            parser.enums.emplace_back(ReadEnum(enum_));
+        }
+
+        reused.emplace(normalized);
+
+        std::lock_guard lock{ASTFileParser::parsersMutex};
+        ASTFileParser::parsers.emplace_back(std::move(parser));
+    }
+
+    std::cout << "Loaded " << reused.size() << " of " << headers.size() << " headers from the cache" << std::endl;
+
+    return outdated;
+}
+
+void ExtractionCache::Invalidate(const std::unordered_set<std::string> &files) {
+    for (const auto &file: files) {
+        fileHashes.erase(file);
+        reused.erase(file);
+    }
+
+    //every entry was extracted with the precompiled header
+    const auto changed = [&files](const std::string &input) { return files.count(input) != 0; };
+    if ((!prelude.empty() && changed(ASTFileParser::NormalizePath(prelude))) ||
+        std::any_of(preludeInputs.begin(), preludeInputs.end(), changed)) {
+        reused.clear();
+    }
+    UpdateArgumentsHash();
+}
+
+void ExtractionCache::SetPreludeInputs(const std::vector<std::string> &inputs) {
+    preludeInputs = inputs;
+    UpdateArgumentsHash();
+}
+
+bool ExtractionCache::Save(const std::vector<ASTFileParser> &parsers) {
+    pugi::xml_document output{};
+    auto root = output.append_child("CodeGeneratorCache");
+    root.append_attribute("version") = version;
+
+    if (!preludeInputs.empty()) {
+        auto node = root.append_child("Prelude");
+        for (const auto &input: preludeInputs) {
+            node.append_child("Input").append_attribute("path") = input.c_str();
+        }
+    }
+
+    for (const auto &parser: parsers) {
+        const auto normalized = ASTFileParser::NormalizePath(parser.path);
+
+        //entries that were loaded are still valid, copy them as is
+        if (reused.count(normalized) != 0) {
+            root.append_copy(entries.at(normalized));
+            continue;
+        }
+
+        auto entry = root.append_child("Header");
+        entry.append_attribute("header") = normalized.c_str();
+        entry.append_attribute("path") = parser.path.string().c_str();
+        entry.append_attribute("key") = static_cast<unsigned long long>(GetKey(normalized));
+
+        for (const auto &dependency: parser.dependencies) {
+            auto node = entry.append_child("Dependency");
+            node.append_attribute("path") = dependency.c_str();
+            node.append_attribute("hash") = static_cast<unsigned long long>(HashFile(dependency));
+        }
+        for (const auto &class_: parser.classes) {
+            WriteClass(entry.append_child("Class"), class_);
+        }
+        for (const auto &function: parser.functions) {
+            WriteFunction(entry.append_child("Function"), function);
+        }
+        for (const auto &variable: parser.variables) {
+            WriteVariable(entry.append_child("Variable"), variable);
+        }
+        for (const auto &enum_: parser.enums) {
+            WriteEnum(entry.append_child("Enum"), enum_);
+        }
+    }
+
+    if (!output.save_file(file.c_str())) {
+        std::cerr << "Error: could not write cache " << file << std::endl;
+        return false;
+    }
+
+    return true;
+}
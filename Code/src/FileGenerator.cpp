@@ -1,80 +1,255 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include "FileGenerator.hpp"
 
+#include <llvm/Support/xxhash.h>
+
 std::filesystem::path FileGenerator::output_directory;
 std::unordered_map<std::string, File> FileGenerator::files;
+size_t FileGenerator::shardCount = 0;
 
-void FileGenerator::WriteFiles() {
-    for( const auto& file : files)
-    {
-        const auto output_file = output_directory / file.first;
+namespace {
+    //returns the sorted elements, unordered containers don't guarantee the same order between runs
+    template<typename Container, typename Projection>
+    auto GetSorted(const Container& container, Projection projection) {
+        std::vector<decltype(&*container.begin())> sorted{};
+        sorted.reserve(container.size());
+        for (const auto& element : container)
+        {
+            sorted.emplace_back(&element);
+        }
         
-        //create the directory if it doesn't exist
-        std::filesystem::create_directories(output_file.parent_path());
+        std::sort(sorted.begin(), sorted.end(), [&projection](const auto* a, const auto* b) {
+            return projection(*a) < projection(*b);
+        });
+        return sorted;
+    }
+    
+    //reads the file in text mode, so line endings match the ones written through an ofstream
+    std::optional<std::string> ReadFile(const std::filesystem::path& path) {
+        std::ifstream input{path};
+        if (!input.is_open())
+        {
+            return std::nullopt;
+        }
         
-        //open the file or create it if it doesn't exist
-        std::ofstream output{output_file};
-        //test if the file is open
-        if (!output.is_open())
+        std::ostringstream content{};
+        content << input.rdbuf();
+        return content.str();
+    }
+}
+
+std::vector<std::pair<std::string, File>> FileGenerator::ShardFile(const std::string& name, const File& file) {
+    std::vector<std::pair<std::string, File>> result{};
+    result.reserve(shardCount + 1);
+    
+    //the file only includes the headers of the functions it keeps, otherwise it is rebuilt whenever any class changes
+    auto& main = result.emplace_back(name, File{{}, file.header, {}, {}}).second;
+    
+    //LuaBindings.cpp.gen becomes LuaBindings.shard0.gen.cpp, ...
+    //a shard is compiled on its own, so it starts with the shard header instead of relying on the file including it
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        auto& shard = result.emplace_back(GetShardName(name, i), File{}).second;
+        shard.header = file.shardHeader;
+        shard.header.insert(shard.header.end(), file.header.begin(), file.header.end());
+    }
+    
+    for (const auto& [functionName, function] : file.functions)
+    {
+        if (file.shardable.count(functionName) == 0)
         {
-            std::cerr << "Error: could not open " << output_file << std::endl;
+            main.functions.emplace(functionName, function);
+            main.includes.insert(function.includes.begin(), function.includes.end());
             continue;
         }
         
-        const auto& file_data = file.second;
+        //the hash only depends on the name, adding or removing a function doesn't move the others
+        auto& shard = result[1 + llvm::xxHash64(functionName) % shardCount].second;
+        shard.functions.emplace(functionName, function);
+        shard.includes.insert(function.includes.begin(), function.includes.end());
+    }
+    
+    return result;
+}
+
+std::string FileGenerator::GetShardName(const std::string& name, size_t index) {
+    return name.substr(0, name.find('.')) + ".shard" + std::to_string(index) + ".gen.cpp";
+}
+
+void FileGenerator::RemoveStaleShards(const std::string& name, size_t count) {
+    const auto path = output_directory / name;
+    const auto filename = path.filename().string();
+    const auto prefix = filename.substr(0, filename.find('.')) + ".shard";
+    const std::string suffix = ".gen.cpp";
+    
+    std::unordered_set<std::string> current{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        current.insert(GetShardName(filename, i));
+    }
+    
+    std::error_code error{};
+    std::vector<std::filesystem::path> stale{};
+    for (const auto& entry : std::filesystem::directory_iterator{path.parent_path(), error})
+    {
+        //only <stem>.shard<number>.gen.cpp files that weren't written in this run
+        const auto entryName = entry.path().filename().string();
+        if (entryName.size() <= prefix.size() + suffix.size() || entryName.compare(0, prefix.size(), prefix) != 0 ||
+            entryName.compare(entryName.size() - suffix.size(), suffix.size(), suffix) != 0 ||
+            current.count(entryName) != 0)
+        {
+            continue;
+        }
         
-        //write the includes
-        for (const auto& include : file_data.includes)
+        const auto number = entryName.substr(prefix.size(), entryName.size() - prefix.size() - suffix.size());
+        if (std::all_of(number.begin(), number.end(), [](char c) { return c >= '0' && c <= '9'; }))
         {
-            output << GetFileInclude(include) << std::endl;
+            stale.emplace_back(entry.path());
         }
+    }
+    
+    //their functions are in the current shards now, compiling both would define every function twice
+    for (const auto& shard : stale)
+    {
+        std::cout << "Removing stale shard " << shard.filename() << std::endl;
+        std::filesystem::remove(shard, error);
+    }
+}
+
+std::string FileGenerator::RenderFile(const File& file) {
+    std::string output{};
+    
+    //write the includes
+    for (const auto* include : GetSorted(file.includes, [](const std::filesystem::path& path) { return path; }))
+    {
+        output += GetFileInclude(*include);
+        output += '\n';
+    }
+    
+    //write the header
+    for (const auto& line : file.header)
+    {
+        output += line;
+        output += '\n';
+    }
+    
+    output += '\n';
+    
+    //write the functions
+    for (const auto* function : GetSorted(file.functions, [](const auto& pair) { return pair.first; }))
+    {
+        const auto& name = function->first;
+        const auto& fullFunction = function->second;
         
-        std::cout << std::endl;
+        //write the prefix
+        output += fullFunction.prefix;
         
         //write the header
-        for (const auto& line : file_data.header)
+        output += fullFunction.header.returnType + " " + name + "(";
+        for (size_t i = 0; i < fullFunction.header.parameters.size(); ++i)
         {
-            output << line << std::endl;
+            output += fullFunction.header.parameters[i].type + " " + fullFunction.header.parameters[i].name;
+            if (i != fullFunction.header.parameters.size() - 1)
+            {
+                output += ", ";
+            }
         }
+        output += ")\n{\n";
         
-        output << std::endl;
+        //write the body
+        for (const auto& line : fullFunction.body)
+        {
+            output += line;
+            output += '\n';
+        }
         
-        //write the functions
-        for (const auto& function : file_data.functions)
+        output += "}\n\n";
+    }
+    
+    return output;
+}
+
+FileGenerator::WriteResult FileGenerator::WriteIfChanged(const std::filesystem::path& path, const std::string& content) {
+    //leave the file and its timestamp alone, otherwise the build system recompiles everything that depends on it
+    if (const auto existing = ReadFile(path); existing.has_value() && *existing == content)
+    {
+        return WriteResult::Unchanged;
+    }
+    
+    //create the directory if it doesn't exist
+    std::error_code error{};
+    std::filesystem::create_directories(path.parent_path(), error);
+    
+    //write to a temporary file first, so the build system never sees a partially written file
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream output{temporary};
+        if (!output.is_open() || !(output << content) || !output.flush())
         {
-            //write the prefix
-            if (!function.second.prefix.empty())
-            {
-                output << function.second.prefix;
-            }
-            
-            //write the header
-            output << function.second.header.returnType << " " << function.first << "(";
-            for (size_t i = 0; i < function.second.header.parameters.size(); ++i)
-            {
-                output << function.second.header.parameters[i].type << " " << function.second.header.parameters[i].name;
-                if (i != function.second.header.parameters.size() - 1)
-                {
-                    output << ", ";
-                }
-            }
-            output << ")" << std::endl << "{" << std::endl;
-            
-            //write the body
-            for (const auto& line : function.second.body)
+            std::cerr << "Error: could not write " << temporary << std::endl;
+            std::filesystem::remove(temporary, error);
+            return WriteResult::Failed;
+        }
+    }
+    
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        std::cerr << "Error: could not replace " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temporary, error);
+        return WriteResult::Failed;
+    }
+    
+    return WriteResult::Written;
+}
+
+void FileGenerator::WriteFiles() {
+    size_t unchanged = 0;
+    size_t total = 0;
+    
+    const auto write = [&unchanged, &total](const std::string& name, const File& file) {
+        ++total;
+        if (WriteIfChanged(output_directory / name, RenderFile(file)) == WriteResult::Unchanged)
+        {
+            ++unchanged;
+        }
+    };
+    
+    for (const auto& file : files)
+    {
+        if (shardCount < 2 || file.second.shardable.empty())
+        {
+            write(file.first, file.second);
+            if (!file.second.shardable.empty())
             {
-                output << line << std::endl;
+                RemoveStaleShards(file.first, 0);
             }
-            
-            output << "}" << std::endl;
-            
-            output << std::endl;
+            continue;
+        }
+        
+        //every shard is written, even an empty one, so the build always sees the same list of files
+        for (const auto& [name, shard] : ShardFile(file.first, file.second))
+        {
+            write(name, shard);
         }
+        RemoveStaleShards(file.first, shardCount);
     }
+    
+    std::cout << "Skipped writing " << unchanged << " of " << total << " generated files, their content is unchanged" << std::endl;
 }
 
 void FileGenerator::Parse(const ASTFileParser &parser) {
+    //files without any classes, variables, or functions are only kept for the cache
+    if (parser.IsEmpty())
+    {
+        return;
+    }
+    
     if (ParseFile)
     {
         ParseFile(*this, parser);
@@ -82,6 +257,11 @@ void FileGenerator::Parse(const ASTFileParser &parser) {
     
     for (const auto& function : parser.functions)
     {
+        if (!IsFirstDeclaration(function))
+        {
+            continue;
+        }
+        
         if (ParseFunction)
         {
             ParseFunction(*this, function);
@@ -90,14 +270,37 @@ void FileGenerator::Parse(const ASTFileParser &parser) {
     
     for (const auto& variable : parser.variables)
     {
+        if (!IsFirstDeclaration(variable))
+        {
+            continue;
+        }
+        
         if (ParseVariable)
         {
             ParseVariable(*this, variable);
         }
     }
     
+    for (const auto& enum_ : parser.enums)
+    {
+        if (!IsFirstDeclaration(enum_))
+        {
+            continue;
+        }
+        
+        if (ParseEnum)
+        {
+            ParseEnum(*this, enum_);
+        }
+    }
+    
     for (const auto& class_ : parser.classes)
     {
+        if (!IsFirstDeclaration(class_))
+        {
+            continue;
+        }
+        
         if (ParseClass)
         {
             ParseClass(*this, class_);
@@ -121,6 +324,11 @@ void FileGenerator::Parse(const ASTFileParser &parser) {
     }
 }
 
+bool FileGenerator::IsFirstDeclaration(const Object &object) {
+    //entities without a USR can't be compared, they are always generated
+    return object.usr.empty() || usrs.insert(object.usr).second;
+}
+
 std::string FileGenerator::GetFileInclude(const std::filesystem::path &path) {
     //for now use absolute paths, later on this should be changed to relative paths
     return "#include \"" + path.string() + "\"";
@@ -130,6 +338,106 @@ std::string FileGenerator::GetFileInclude(const ASTFileParser &parser) {
     return GetFileInclude(parser.path);
 }
 
+std::string FileGenerator::GetIdentifier(const Object &object) {
+    std::string identifier{};
+    identifier.reserve(object.fullNamespace.size());
+    
+    for (size_t i = 0; i < object.fullNamespace.size(); ++i)
+    {
+        if (object.fullNamespace.compare(i, 2, "::") == 0)
+        {
+            identifier += '_';
+            ++i;
+        }
+        else
+        {
+            identifier += object.fullNamespace[i];
+        }
+    }
+    
+    return identifier;
+}
+
+bool FileGenerator::IsNameable(const Object &object) {
+    return object.fullNamespace.find("(anonymous") == std::string::npos;
+}
+
+bool FileGenerator::IsAccessible(const Class &class_, const Variable &variable, const std::string &generated) {
+    if (!variable.isPublic)
+    {
+        std::cerr << "Warning: " << class_.fullNamespace << "::" << variable.name << " is not public, the " << generated
+                  << " of " << class_.fullNamespace << " leaves it out" << std::endl;
+    }
+    return variable.isPublic;
+}
+
+std::vector<MemberRun> FileGenerator::GetMemberRuns(const Class &class_, const std::string &generated) {
+    std::vector<MemberRun> runs{};
+    for (const auto& variable : class_.variables)
+    {
+        //a member that is left out ends the run, the next member has another field index
+        if (!IsAccessible(class_, variable, generated))
+        {
+            continue;
+        }
+        
+        //members of classes with virtual bases have no fixed offset, so every member is a run of its own
+        const bool copyable = variable.isTriviallyCopyable && !variable.isBitField;
+        if (copyable && !class_.hasVirtualBases && !runs.empty() && runs.back().isTriviallyCopyable &&
+            runs.back().members.back()->fieldIndex + 1 == variable.fieldIndex)
+        {
+            runs.back().members.emplace_back(&variable);
+        }
+        else
+        {
+            runs.push_back({{&variable}, copyable});
+        }
+    }
+    return runs;
+}
+
+std::vector<std::string> &FileGenerator::BeginSpecialization(const std::string &fileName, const Object &object,
+                                                             const std::string &runtimeHeader) {
+    auto& header = files[fileName].header;
+    header.clear();
+    header.emplace_back("#pragma once");
+    header.emplace_back("");
+    header.emplace_back(GetFileInclude(object.path));
+    header.emplace_back("#include <" + runtimeHeader + ">");
+    header.emplace_back("");
+    header.emplace_back("namespace CodeGenerator {");
+    header.emplace_back("    template<>");
+    return header;
+}
+
+std::vector<std::string> &FileGenerator::BeginSpecialization(const std::string &fileName, const Class &class_,
+                                                             const std::string &runtimeHeader) {
+    auto& header = BeginSpecialization(fileName, static_cast<const Object&>(class_), runtimeHeader);
+    
+    //compilers support offsetof for classes that aren't standard layout as long as there are no virtual bases
+    if (!class_.isStandardLayout)
+    {
+        header.insert(header.end() - 2, {
+                "#if defined(__GNUC__)",
+                "#pragma GCC diagnostic push",
+                "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"",
+                "#endif",
+                ""
+        });
+    }
+    return header;
+}
+
+void FileGenerator::EndSpecialization(std::vector<std::string> &header, const Class &class_) {
+    if (!class_.isStandardLayout)
+    {
+        header.emplace_back("");
+        header.emplace_back("#if defined(__GNUC__)");
+        header.emplace_back("#pragma GCC diagnostic pop");
+        header.emplace_back("#endif");
+    }
+}
+
 const Property *FileGenerator::GetProperty(const std::vector<Property> &properties, const std::string &name) {
     const auto it = std::find_if(properties.begin(), properties.end(), [&name](const Property& in) { return in.name == name; });
     if (it != properties.end())
@@ -138,3 +446,12 @@ const Property *FileGenerator::GetProperty(const std::vector<Property> &properti
     }
     return nullptr;
 }
+
+const Property *FileGenerator::GetProperty(const std::vector<Property> &properties, PropertyKey key) {
+    const auto it = std::find_if(properties.begin(), properties.end(), [key](const Property& in) { return in.key == key; });
+    if (it != properties.end())
+    {
+        return &*it;
+    }
+    return nullptr;
+}
@@ -1,10 +1,280 @@
 #include "FileParser.hpp"
 #include "FileGenerator.hpp"
+#include "PropertyParser.hpp"
 
+#include <clang/AST/Attr.h>
+#include <clang/Index/USRGeneration.h>
+#include <clang/Lex/Lexer.h>
+#include <clang/Sema/ParsedAttr.h>
+#include <clang/Sema/Sema.h>
+#include <llvm/ADT/DenseMap.h>
+
+#include <algorithm>
+#include <cctype>
 #include <iostream>
-#include <regex>
+#include <limits>
+#include <optional>
+#include <unordered_map>
 
 std::vector<ASTFileParser> ASTFileParser::parsers{};
+std::mutex ASTFileParser::parsersMutex{};
+std::unordered_set<std::string> ASTFileParser::unityHeaders{};
+std::unordered_set<std::string> ASTFileParser::claimedHeaders{};
+
+std::unordered_set<std::string> ASTFileParser::projectHeaders{};
+bool ASTFileParser::fastTraversal = false;
+
+namespace {
+    //maps every file in the translation unit to the files it includes directly, all paths are normalized
+    std::unordered_map<std::string, std::vector<std::string>> GetIncludeGraph(const clang::SourceManager &sourceManager) {
+        std::unordered_map<std::string, std::vector<std::string>> graph{};
+
+        //entry 0 is a sentinel, every file entry records the location it was included from
+        for (unsigned i = 1; i < sourceManager.local_sloc_entry_size(); ++i) {
+            const auto &entry = sourceManager.getLocalSLocEntry(i);
+            if (!entry.isFile()) {
+                continue;
+            }
+
+            const auto includeLocation = entry.getFile().getIncludeLoc();
+            if (includeLocation.isInvalid()) {
+                continue;
+            }
+
+            const auto includer = sourceManager.getFilename(includeLocation);
+            if (includer.empty()) {
+                continue;
+            }
+
+            graph[ASTFileParser::NormalizePath(includer.str())].emplace_back(
+                    ASTFileParser::NormalizePath(entry.getFile().getName().str()));
+        }
+
+        return graph;
+    }
+
+    //returns the project headers reachable from file, not including file itself
+    std::vector<std::string> GetDependencies(const std::unordered_map<std::string, std::vector<std::string>> &graph,
+                                             const std::string &file,
+                                             const std::unordered_set<std::string> &projectHeaders) {
+        std::vector<std::string> dependencies{};
+        std::unordered_set<std::string> visited{file};
+        std::vector<const std::string *> stack{&file};
+
+        while (!stack.empty()) {
+            const auto it = graph.find(*stack.back());
+            stack.pop_back();
+            if (it == graph.end()) {
+                continue;
+            }
+
+            //only project headers are followed, system headers don't include project headers
+            for (const auto &include: it->second) {
+                if (projectHeaders.count(include) == 0 || !visited.insert(include).second) {
+                    continue;
+                }
+
+                dependencies.emplace_back(include);
+                stack.emplace_back(&include);
+            }
+        }
+
+        std::sort(dependencies.begin(), dependencies.end());
+        return dependencies;
+    }
+
+    //returns the arguments of the "cg:" annotation that matches the keyword, CGCLASS matches cg:class(...)
+    //the arguments are empty if the annotation has no parentheses, nullopt if the decl has no matching annotation
+    std::optional<std::string> GetAnnotationArguments(const clang::Decl &decl, const std::string &keyword) {
+        if (!decl.hasAttrs()) {
+            return std::nullopt;
+        }
+
+        std::string name = "cg:";
+        for (size_t i = 2; i < keyword.size(); ++i) {
+            name += static_cast<char>(std::tolower(static_cast<unsigned char>(keyword[i])));
+        }
+
+        for (const auto *attribute: decl.specific_attrs<clang::AnnotateAttr>()) {
+            auto annotation = attribute->getAnnotation();
+            if (!annotation.consume_front(name)) {
+                continue;
+            }
+
+            annotation = annotation.trim();
+            if (annotation.empty()) {
+                return std::string{};
+            }
+
+            //cg:classX is a different annotation, not cg:class with garbage behind it
+            if (annotation.consume_front("(") && annotation.consume_back(")")) {
+                return annotation.str();
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    //[[cg::class("LuaClass, Name=Value")]] is stored as the annotation cg:class(LuaClass, Name=Value)
+    //clang looks up attributes it doesn't know in this registry, so no plugin has to be loaded
+    class CodeGeneratorAttributeInfo : public clang::ParsedAttrInfo {
+    public:
+        CodeGeneratorAttributeInfo() {
+            OptArgs = 1;
+
+            static constexpr Spelling spellings[] = {
+                    {clang::ParsedAttr::AS_CXX11, "cg::class"},
+                    {clang::ParsedAttr::AS_CXX11, "cg::member"},
+                    {clang::ParsedAttr::AS_CXX11, "cg::method"},
+                    {clang::ParsedAttr::AS_CXX11, "cg::function"},
+                    {clang::ParsedAttr::AS_CXX11, "cg::variable"},
+                    {clang::ParsedAttr::AS_CXX11, "cg::constructor"},
+                    {clang::ParsedAttr::AS_CXX11, "cg::enum"}
+            };
+            Spellings = spellings;
+        }
+
+        AttrHandling handleDeclAttribute(clang::Sema &sema, clang::Decl *decl,
+                                         const clang::ParsedAttr &attribute) const override {
+            std::string annotation = "cg:" + attribute.getAttrName()->getName().str();
+
+            if (attribute.getNumArgs() > 0) {
+                const auto *argument = attribute.isArgExpr(0) ? llvm::dyn_cast<clang::StringLiteral>(
+                        attribute.getArgAsExpr(0)->IgnoreParenCasts()) : nullptr;
+                if (argument == nullptr) {
+                    const auto id = sema.getDiagnostics().getCustomDiagID(
+                            clang::DiagnosticsEngine::Error, "the argument of a cg:: attribute must be a string literal");
+                    sema.Diag(attribute.getLoc(), id);
+                    return AttributeNotApplied;
+                }
+
+                annotation += "(" + argument->getString().str() + ")";
+            }
+
+            decl->addAttr(clang::AnnotateAttr::Create(sema.Context, annotation, nullptr, 0, attribute.getRange()));
+            return AttributeApplied;
+        }
+    };
+
+    //invalid properties are reported, the decl is still handled with the properties before the error
+    void ReportPropertyError(const clang::Decl &decl, const PropertyParser::Error &error, bool lineAbove) {
+        const auto &sourceManager = decl.getASTContext().getSourceManager();
+        const auto location = sourceManager.getPresumedLoc(sourceManager.getSpellingLoc(decl.getLocation()));
+        if (location.isInvalid()) {
+            std::cerr << "Warning: invalid properties: " << error.message << std::endl;
+            return;
+        }
+
+        if (lineAbove) {
+            std::cerr << "Warning: " << location.getFilename() << ":" << location.getLine() - 1 << ":"
+                      << error.position + 1 << ": invalid properties: " << error.message << std::endl;
+        } else {
+            std::cerr << "Warning: " << location.getFilename() << ":" << location.getLine()
+                      << ": invalid properties at offset " << error.position << " of the annotation: "
+                      << error.message << std::endl;
+        }
+    }
+
+    //the unified symbol resolution of the decl, the same entity has the same USR in every translation unit
+    std::string GetUSR(const clang::Decl &decl) {
+        llvm::SmallString<128> usr{};
+        if (clang::index::generateUSRForDecl(&decl, usr)) {
+            return {};
+        }
+        return std::string{usr.str()};
+    }
+
+    //the return type of functions, the type of other values
+    clang::QualType GetDeclType(const clang::NamedDecl &decl) {
+        if (const auto *function = llvm::dyn_cast<clang::FunctionDecl>(&decl)) {
+            return function->getReturnType();
+        }
+        if (const auto *value = llvm::dyn_cast<clang::ValueDecl>(&decl)) {
+            return value->getType();
+        }
+        return {};
+    }
+
+    //the type as printed by clang, used when the type can't be read from the source
+    std::string GetPrintedType(const clang::NamedDecl &decl) {
+        const auto type = GetDeclType(decl);
+        return type.isNull() ? std::string{} : type.getAsString();
+    }
+
+    clang::ParsedAttrInfoRegistry::Add<CodeGeneratorAttributeInfo> codeGeneratorAttribute{
+            "cg", "code generator annotations, stored as cg: annotate attributes"
+    };
+}
+
+std::string ASTFileParser::NormalizePath(const std::filesystem::path &path) {
+    return std::filesystem::absolute(path).lexically_normal().string();
+}
+
+void ASTFileParser::SetUnityHeaders(const std::vector<std::filesystem::path> &headers) {
+    unityHeaders.clear();
+    for (const auto &header: headers) {
+        unityHeaders.emplace(NormalizePath(header));
+    }
+
+    std::lock_guard lock{parsersMutex};
+    claimedHeaders.clear();
+}
+
+bool ASTFileParser::ClaimHeader(const std::string &header) {
+    std::lock_guard lock{parsersMutex};
+    return claimedHeaders.insert(header).second;
+}
+
+bool ASTFileParser::IsHeaderClaimed(const std::filesystem::path &header) {
+    const auto normalized = NormalizePath(header);
+
+    std::lock_guard lock{parsersMutex};
+    return claimedHeaders.count(normalized) != 0;
+}
+
+void ASTFileParser::SetProjectHeaders(const std::vector<std::filesystem::path> &headers) {
+    projectHeaders.clear();
+    for (const auto &header: headers) {
+        projectHeaders.emplace(NormalizePath(header));
+    }
+}
+
+void ASTFileParser::RemoveParsers(const std::unordered_set<std::string> &files) {
+    std::lock_guard lock{parsersMutex};
+    parsers.erase(std::remove_if(parsers.begin(), parsers.end(), [&files](const ASTFileParser &parser) {
+        return files.count(NormalizePath(parser.path)) != 0;
+    }), parsers.end());
+}
+
+void ASTFileParser::SortParsers(const std::vector<std::string> &order) {
+    //clang reports absolute paths, so compare the normalized absolute paths
+    std::unordered_map<std::string, size_t> indices{};
+    indices.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        indices.emplace(NormalizePath(order[i]), i);
+    }
+
+    std::lock_guard lock{parsersMutex};
+
+    //compute the position of every parser once, then sort the positions instead of the parsers
+    std::vector<std::pair<size_t, size_t>> positions{};
+    positions.reserve(parsers.size());
+    for (size_t i = 0; i < parsers.size(); ++i) {
+        const auto it = indices.find(NormalizePath(parsers[i].path));
+        positions.emplace_back(it != indices.end() ? it->second : indices.size(), i);
+    }
+
+    std::stable_sort(positions.begin(), positions.end(), [](const auto &a, const auto &b) {
+        return a.first != b.first ? a.first < b.first : parsers[a.second].path < parsers[b.second].path;
+    });
+
+    std::vector<ASTFileParser> sorted{};
+    sorted.reserve(parsers.size());
+    for (const auto &position: positions) {
+        sorted.emplace_back(std::move(parsers[position.second]));
+    }
+    parsers = std::move(sorted);
+}
 
 bool ASTFileParser::TraverseCXXRecordDecl(clang::CXXRecordDecl *decl) {
 
@@ -15,10 +285,20 @@ bool ASTFileParser::TraverseCXXRecordDecl(clang::CXXRecordDecl *decl) {
     }
 
     auto properties = GetProperties(*decl, "CGCLASS");
-    //if properties is empty skip recursive traversal and continue to next decl
+    //if properties is empty skip the members, but not the enums and classes declared in the class
+    //those can be annotated themselves, like a CGENUM in a plain struct
     if (properties.empty()) {
+        for (auto *nested: decl->decls()) {
+            if (auto *enum_ = llvm::dyn_cast<clang::EnumDecl>(nested)) {
+                TraverseEnumDecl(enum_);
+            } else if (auto *record = llvm::dyn_cast<clang::CXXRecordDecl>(nested);
+                       record && !record->isInjectedClassName()) {
+                TraverseCXXRecordDecl(record);
+            }
+        }
         return true;
     }
+    ++annotated_entities;
 
     //handle setup here:
     {
@@ -27,11 +307,20 @@ bool ASTFileParser::TraverseCXXRecordDecl(clang::CXXRecordDecl *decl) {
 
         Class.fullNamespace = decl->getQualifiedNameAsString();
         Class.name = decl->getNameAsString();
+        Class.usr = GetUSR(*decl);
+        if (const auto *namespace_ = llvm::dyn_cast<clang::NamespaceDecl>(
+                decl->getDeclContext()->getEnclosingNamespaceContext())) {
+            Class.enclosingNamespace = namespace_->getQualifiedNameAsString();
+        }
+        if (decl->hasDefinition()) {
+            Class.isStandardLayout = decl->isStandardLayout();
+            Class.hasVirtualBases = decl->getNumVBases() != 0;
+        }
 //        auto& sourceManager = decl->getASTContext().getSourceManager();
         Class.path = path/*sourceManager.getFileEntryRefForID(
                 sourceManager.getFileID(decl->getLocation())
                 )->getName().str()*/;
-        Class.properties = properties;
+        Class.SetProperties(std::move(properties));
     }
 
     bool result = clang::RecursiveASTVisitor<ASTFileParser>::TraverseCXXRecordDecl(decl);
@@ -56,19 +345,31 @@ bool ASTFileParser::TraverseFieldDecl(clang::FieldDecl *decl) {
     if (properties.empty()) {
         return true;
     }
+    ++annotated_entities;
 
     auto &Class = classes[classStack.top()];
     auto &var = Class.variables.emplace_back();
 
     var.fullNamespace = decl->getQualifiedNameAsString();
     var.name = decl->getNameAsString();
+    var.usr = GetUSR(*decl);
 //    auto& sourceManager = decl->getASTContext().getSourceManager();
     var.path = path/*sourceManager.getFileEntryRefForID(
             sourceManager.getFileID(decl->getLocation())
     )->getName().str()*/;
 
     var.type = GetTypeAsString(*decl);
-    var.properties = properties;
+    //dependent types have no layout until the template is instantiated
+    const auto type = decl->getType();
+    var.isTriviallyCopyable = !type->isDependentType() && !type->isReferenceType() &&
+                              type.isTriviallyCopyableType(decl->getASTContext());
+    var.isBitField = decl->isBitField();
+    var.isArray = type->isArrayType();
+    var.isReference = type->isReferenceType();
+    var.isConst = type.isConstQualified();
+    var.fieldIndex = decl->getFieldIndex();
+    var.isPublic = decl->getAccess() == clang::AS_public;
+    var.SetProperties(std::move(properties));
 
     return clang::RecursiveASTVisitor<ASTFileParser>::TraverseFieldDecl(decl);
 }
@@ -85,19 +386,21 @@ bool ASTFileParser::TraverseCXXMethodDecl(clang::CXXMethodDecl *decl) {
     if (properties.empty()) {
         return true;
     }
+    ++annotated_entities;
 
     //handle setup here:
     {
         auto &Function = functionStack.emplace();
         Function.fullNamespace = decl->getQualifiedNameAsString();
         Function.name = decl->getNameAsString();
+        Function.usr = GetUSR(*decl);
 //        auto& sourceManager = decl->getASTContext().getSourceManager();
         Function.path = path/*sourceManager.getFileEntryRefForID(
                 sourceManager.getFileID(decl->getLocation())
         )->getName().str()*/;
 
         Function.returnType = GetTypeAsString(*decl);
-        Function.properties = properties;
+        Function.SetProperties(std::move(properties));
     }
 
     bool result = clang::RecursiveASTVisitor<ASTFileParser>::TraverseCXXMethodDecl(decl);
@@ -142,23 +445,111 @@ bool ASTFileParser::TraverseParmVarDecl(clang::ParmVarDecl *decl) {
     return clang::RecursiveASTVisitor<ASTFileParser>::TraverseParmVarDecl(decl);
 }
 
+bool ASTFileParser::TraverseStmt(clang::Stmt *stmt, DataRecursionQueue *queue) {
+    if (fastTraversal) {
+        return true;
+    }
+
+    return clang::RecursiveASTVisitor<ASTFileParser>::TraverseStmt(stmt, queue);
+}
+
 std::string ASTFileParser::GetTypeAsString(const clang::NamedDecl &type) {
-    //get file location
-    //get start and ending character
-    clang::SourceRange range = type.getSourceRange();
-    clang::SourceManager &sm = type.getASTContext().getSourceManager();
-
-    llvm::StringRef source = clang::Lexer::getSourceText(clang::CharSourceRange::getCharRange(range), sm,
-                                                         clang::LangOptions());
-
-    std::string name = type.getNameAsString();
-    //find string before the first space before name
-    std::string typeString = source.str().substr(0, source.str().rfind(' ', source.str().find(name)));
-    //remove "static" from the string
-    std::regex staticRegex(R"(static\s+)");
-    typeString = std::regex_replace(typeString, staticRegex, "");
-
-    return typeString;
+    const auto &sourceManager = type.getASTContext().getSourceManager();
+
+    //types spelled through a macro have no source text in the header, let clang print them instead
+    //unnamed decls, like unnamed parameters, have no name to stop at
+    if (type.getBeginLoc().isMacroID() || type.getLocation().isMacroID() || type.getDeclName().isEmpty()) {
+        return GetPrintedType(type);
+    }
+
+    //the type is spelled between the start of the decl and its name
+    const auto [fileID, beginOffset] = sourceManager.getDecomposedLoc(type.getBeginLoc());
+    const auto [nameFileID, nameOffset] = sourceManager.getDecomposedLoc(type.getLocation());
+    if (fileID.isInvalid() || fileID != nameFileID || beginOffset > nameOffset) {
+        return GetPrintedType(type);
+    }
+
+    //decls in the same declaration start at the same offset, e.g. int a, b;
+    //the declarators of the later decls can change the type, e.g. int a, *b; those are printed by clang
+    const auto key = static_cast<uint64_t>(fileID.getHashValue()) << 32 | beginOffset;
+    if (const auto it = typeSpellings.find(key); it != typeSpellings.end()) {
+        if (it->second.first == GetDeclType(type)) {
+            return it->second.second;
+        }
+        return GetPrintedType(type);
+    }
+
+    bool invalid = false;
+    const auto buffer = sourceManager.getBufferData(fileID, &invalid);
+    if (invalid) {
+        return GetPrintedType(type);
+    }
+
+    //the raw lexer works directly on the buffer, no preprocessing or allocations are involved
+    clang::Lexer lexer{sourceManager.getLocForStartOfFile(fileID), type.getASTContext().getLangOpts(),
+                       buffer.begin(), buffer.begin() + beginOffset, buffer.end()};
+
+    const char *const nameStart = buffer.begin() + nameOffset;
+    const char *previousEnd = nullptr;
+    //depth of the [[...]] attribute or the parentheses of __attribute__((...)) that is being skipped
+    unsigned squareDepth = 0;
+    unsigned parenDepth = 0;
+    bool skipParens = false;
+
+    std::string result{};
+    clang::Token token{};
+
+    while (true) {
+        lexer.LexFromRawLexer(token);
+
+        const char *tokenEnd = lexer.getBufferLocation();
+        const char *tokenStart = tokenEnd - token.getLength();
+        if (token.is(clang::tok::eof) || tokenStart >= nameStart) {
+            break;
+        }
+
+        //attributes in front of the decl are not part of its type
+        if (token.is(clang::tok::l_square) && (squareDepth > 0 || (tokenEnd < nameStart && *tokenEnd == '['))) {
+            ++squareDepth;
+            continue;
+        }
+        if (squareDepth > 0) {
+            squareDepth -= token.is(clang::tok::r_square);
+            continue;
+        }
+        if (skipParens && token.is(clang::tok::l_paren)) {
+            ++parenDepth;
+            skipParens = false;
+            continue;
+        }
+        if (parenDepth > 0) {
+            parenDepth += token.is(clang::tok::l_paren);
+            parenDepth -= token.is(clang::tok::r_paren);
+            continue;
+        }
+
+        if (token.is(clang::tok::raw_identifier)) {
+            const auto identifier = token.getRawIdentifier();
+            if (identifier == "__attribute__" || identifier == "__declspec" || identifier == "alignas") {
+                skipParens = true;
+                continue;
+            }
+            //static is part of the decl, not of its type
+            if (identifier == "static") {
+                continue;
+            }
+        }
+
+        //tokens that were separated in the source are separated by a single space
+        if (!result.empty() && tokenStart != previousEnd) {
+            result += ' ';
+        }
+        result.append(tokenStart, tokenEnd);
+        previousEnd = tokenEnd;
+    }
+
+    typeSpellings.emplace(key, std::make_pair(GetDeclType(type), result));
+    return result;
 }
 
 bool ASTFileParser::TraverseCXXConstructorDecl(clang::CXXConstructorDecl *decl) {
@@ -173,12 +564,14 @@ bool ASTFileParser::TraverseCXXConstructorDecl(clang::CXXConstructorDecl *decl)
     if (properties.empty()) {
         return true;
     }
+    ++annotated_entities;
 
     //handle setup here:
     {
         auto &Function = functionStack.emplace();
         Function.fullNamespace = decl->getQualifiedNameAsString();
         Function.name = decl->getNameAsString();
+        Function.usr = GetUSR(*decl);
 //        auto& sourceManager = decl->getASTContext().getSourceManager();
         Function.path = path/*sourceManager.getFileEntryRefForID(
                 sourceManager.getFileID(decl->getLocation())
@@ -186,7 +579,7 @@ bool ASTFileParser::TraverseCXXConstructorDecl(clang::CXXConstructorDecl *decl)
 
         Function.returnType = "void";
         Function.isConstruptor = true;
-        Function.properties = properties;
+        Function.SetProperties(std::move(properties));
     }
 
     bool result = clang::RecursiveASTVisitor<ASTFileParser>::TraverseCXXConstructorDecl(decl);
@@ -212,22 +605,70 @@ bool ASTFileParser::TraverseVarDecl(clang::VarDecl *decl) {
     if (properties.empty()) {
         return true;
     }
+    ++annotated_entities;
 
     auto &var = variables.emplace_back();
 
     var.fullNamespace = decl->getQualifiedNameAsString();
     var.name = decl->getNameAsString();
+    var.usr = GetUSR(*decl);
 //    auto& sourceManager = decl->getASTContext().getSourceManager();
     var.path = path/*sourceManager.getFileEntryRefForID(
             sourceManager.getFileID(decl->getLocation())
     )->getName().str()*/;
 
     var.type = GetTypeAsString(*decl);
-    var.properties = properties;
+    var.SetProperties(std::move(properties));
 
     return clang::RecursiveASTVisitor<ASTFileParser>::TraverseVarDecl(decl);
 }
 
+bool ASTFileParser::TraverseEnumDecl(clang::EnumDecl *decl) {
+    //test if decl is from current file, if not skip recursive traversal and continue to next decl
+    if (DeclIsIncluded(*decl)) {
+        return true;
+    }
+
+    //forward declarations have no enumerators, anonymous enums can't be named by the generated code
+    if (!decl->isThisDeclarationADefinition() || decl->getName().empty()) {
+        return true;
+    }
+
+    auto properties = GetProperties(*decl, "CGENUM");
+    //if properties is empty skip recursive traversal and continue to next decl
+    if (properties.empty()) {
+        return true;
+    }
+    ++annotated_entities;
+
+    auto &enum_ = enums.emplace_back();
+
+    enum_.fullNamespace = decl->getQualifiedNameAsString();
+    enum_.name = decl->getNameAsString();
+    enum_.usr = GetUSR(*decl);
+    enum_.path = path;
+    //the canonical type is a builtin type, a typedef like Id can't be named from outside its namespace
+    if (const auto underlyingType = decl->getIntegerType(); !underlyingType.isNull()) {
+        enum_.underlyingType = underlyingType.getCanonicalType().getAsString();
+    }
+    enum_.isScoped = decl->isScoped();
+    enum_.SetProperties(std::move(properties));
+
+    for (const auto *constant: decl->enumerators()) {
+        auto &enumerator = enum_.enumerators.emplace_back();
+        enumerator.fullNamespace = constant->getQualifiedNameAsString();
+        enumerator.name = constant->getNameAsString();
+        enumerator.path = path;
+
+        //unsigned values above the signed range wrap around, the generated code casts them back the same way
+        const auto &value = constant->getInitVal();
+        enumerator.value = value.isSigned() ? value.getSExtValue() : static_cast<int64_t>(value.getZExtValue());
+    }
+
+    //enumerators are read above, they are never annotated themselves
+    return true;
+}
+
 bool ASTFileParser::TraverseFunctionDecl(clang::FunctionDecl *decl) {
     //test if decl is from current file, if not skip recursive traversal and continue to next decl
     if (DeclIsIncluded(*decl)) {
@@ -240,19 +681,21 @@ bool ASTFileParser::TraverseFunctionDecl(clang::FunctionDecl *decl) {
     if (properties.empty()) {
         return true;
     }
+    ++annotated_entities;
 
     //handle setup here:
     {
         auto &Function = functionStack.emplace();
         Function.fullNamespace = decl->getQualifiedNameAsString();
         Function.name = decl->getNameAsString();
+        Function.usr = GetUSR(*decl);
 //        auto& sourceManager = decl->getASTContext().getSourceManager();
         Function.path = path/*sourceManager.getFileEntryRefForID(
                 sourceManager.getFileID(decl->getLocation())
         )->getName().str()*/;
 
         Function.returnType = GetTypeAsString(*decl);
-        Function.properties = properties;
+        Function.SetProperties(std::move(properties));
     }
 
     bool result = clang::RecursiveASTVisitor<ASTFileParser>::TraverseFunctionDecl(decl);
@@ -267,128 +710,260 @@ bool ASTFileParser::TraverseFunctionDecl(clang::FunctionDecl *decl) {
 }
 
 std::string ASTFileParser::GetLineAbove(const clang::Decl &decl) {
-    //get the line number of the declaration
-    size_t lineNumber = decl.getASTContext().getSourceManager().getSpellingLineNumber(decl.getLocation());
+    const auto &sourceManager = decl.getASTContext().getSourceManager();
 
-    //test if line number is 1, if so return empty string
-    if (lineNumber == 1) {
-        return {};
-    }
+    //the annotation is written above the decl in the source, so use the spelling location
+    const auto [fileID, offset] = sourceManager.getDecomposedSpellingLoc(decl.getLocation());
 
-    //get the file
-    std::string fileName = decl.getASTContext().getSourceManager().getFilename(decl.getLocation()).str();
-
-    //test if the file is open, if not open it
-    if (!file.is_open() || file.rdstate() != std::ifstream::goodbit) {
-        file.open(fileName);
+    //the file is already loaded by clang, read the line directly from its buffer instead of from disk
+    bool invalid = false;
+    const auto buffer = sourceManager.getBufferData(fileID, &invalid);
+    if (invalid || offset > buffer.size()) {
+        return {};
     }
 
-    //set cursor to the beginning of the file
-    file.seekg(std::ios::beg);
-    //set cursor to the line before the declaration
-    for (size_t i = 0; i < lineNumber - 2; ++i) {
-        file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    //only the characters between the decl and the line above are scanned, not the whole file
+    //the newline ending the line above, if there is none the decl is on the first line
+    const auto lineEnd = buffer.rfind('\n', offset);
+    if (lineEnd == llvm::StringRef::npos) {
+        return {};
     }
 
-    //get the line
-    std::string line;
-    std::getline(file, line);
+    //the newline ending the line before that, if there is none the line above is the first line
+    const auto previousEnd = buffer.rfind('\n', lineEnd);
+    auto line = buffer.slice(previousEnd == llvm::StringRef::npos ? 0 : previousEnd + 1, lineEnd);
 
-    //close the file
-    file.close();
+    //files with windows line endings leave a carriage return at the end of the line
+    if (line.ends_with("\r")) {
+        line = line.drop_back();
+    }
 
-    //return the line
-    return line;
+    return line.str();
 }
 
-//TODO: Function does not handle list of properties as value
 std::vector<Property> ASTFileParser::GetProperties(const clang::Decl &decl, std::string keyword) {
-    auto line = GetLineAbove(decl);
+    std::vector<Property> result{{keyword}};
+
+    //annotations are part of the AST, so they don't require looking at the source
+    if (const auto arguments = GetAnnotationArguments(decl, keyword); arguments.has_value()) {
+        size_t end = 0;
+        auto error = PropertyParser::Parse(*arguments, result, &end);
+        if (!error.has_value() && end != arguments->size()) {
+            error = PropertyParser::Error{end, "unexpected ')'"};
+        }
+        if (error.has_value()) {
+            ReportPropertyError(decl, *error, false);
+        }
+        return result;
+    }
+
+    const auto line = GetLineAbove(decl);
+    const std::string_view text{line};
 
     //test if the line starts with the keyword (ignoring whitespace)
     //if not return empty vector
-    //remove leading whitespace
-    line.erase(line.begin(), std::find_if(line.begin(), line.end(), [](int ch) { return !std::isspace(ch); }));
-    if (line.find(keyword) != 0) {
-//        auto *namedDecl = const_cast<clang::NamedDecl *>(clang::dyn_cast<clang::NamedDecl>(&decl));
-//        std::cerr << "No properties found for:" <<  namedDecl->getQualifiedNameAsString() << std::endl;
+    const auto start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos || text.compare(start, keyword.size(), keyword) != 0) {
         return {};
     }
 
-    //find the first opening brace
-    auto openBracePos = line.find('(');
-    //find matching closing brace
-    auto closeBracePos = line.find(')', openBracePos);
-
-    //get the substring between the braces
-    auto propertiesString = line.substr(openBracePos + 1, closeBracePos - openBracePos - 1);
-
-    //split the string by commas
-    std::vector<std::string> properties{};
-    std::string::size_type pos = 0;
-    std::string::size_type prev = 0;
-    while ((pos = propertiesString.find(',', pos)) != std::string::npos) {
-        properties.emplace_back(propertiesString.substr(prev, pos - prev));
-        prev = ++pos;
+    //the properties are between the parentheses following the keyword
+    const auto open = text.find('(', start + keyword.size());
+    if (open == std::string_view::npos) {
+        return result;
     }
 
-    //add the last property
-    properties.emplace_back(propertiesString.substr(prev, pos - prev));
+    size_t end = 0;
+    auto error = PropertyParser::Parse(text.substr(open + 1), result, &end);
+    if (!error.has_value() && open + 1 + end == text.size()) {
+        error = PropertyParser::Error{end, "missing ')'"};
+    }
+    if (error.has_value()) {
+        //report the position in the line instead of the position in the list
+        error->position += open + 1;
+        ReportPropertyError(decl, *error, true);
+    }
 
-    //parse the properties.
-    //properties should be in the format "name"="value".
-    //value is optional, and if it is not present the value should be an empty string.
-    //TODO: Value can also be a comma seperated list of properties
-    std::vector<Property> result{{keyword}};
-    for (const auto &property: properties) {
-        //find the first equals sign
-        auto equalsPos = property.find('=');
+    return result;
+}
 
-        //get the name
-        auto name = property.substr(0, equalsPos);
+bool ASTFileParser::DeclIsIncluded(const clang::Decl &decl) {
+    ++decls_visited;
 
-        //get the value
-        auto value = property.substr(equalsPos + 1);
+    const auto &sourceManager = decl.getASTContext().getSourceManager();
+    const auto fileID = sourceManager.getFileID(sourceManager.getExpansionLoc(decl.getLocation()));
+    if (fileID == mainFileID) {
+        return false;
+    }
 
-        //remove whitespace from the name
-        name.erase(std::remove_if(name.begin(), name.end(), [](char c) { return std::isspace(c); }), name.end());
-        //remove whitespace from the value
-        value.erase(std::remove_if(value.begin(), value.end(), [](char c) { return std::isspace(c); }), value.end());
+    //decls of an included file come in runs, most are rejected by the FileID of the previous rejected decl
+    if (fileID == includedFileID) {
+        ++decls_skipped;
+        ++decls_skipped_by_file_id;
+        return true;
+    }
 
-        //add the property to the result
-        result.emplace_back(Property{name, value});
+    //a header without include guards gets a new FileID every time it is included, compare the files themselves
+    const auto *fileEntry = sourceManager.getFileEntryForID(fileID);
+    if (fileEntry != nullptr && fileEntry == mainFileEntry) {
+        return false;
     }
 
-    return result;
+    includedFileID = fileID;
+    ++decls_skipped;
+    return true;
 }
 
-bool ASTFileParser::DeclIsIncluded(const clang::Decl &decl) {
-    const auto &SourceManager = decl.getASTContext().getSourceManager();
-    const auto FileEntryRef = SourceManager.getFileEntryRefForID(
-            SourceManager.getFileID(decl.getLocation())
-    );
-    return FileEntryRef.has_value() && FileEntryRef->getName().str() != path;
+void ASTFileParser::SetMainFile(const clang::SourceManager &sourceManager, clang::FileID fileID) {
+    mainFileID = fileID;
+    mainFileEntry = sourceManager.getFileEntryForID(fileID);
+    includedFileID = {};
+}
+
+bool ASTFrontendAction::BeginInvocation(clang::CompilerInstance &compilerInstance) {
+    start = Statistics::Clock::now();
+    traversalTime = {};
+
+    //function bodies never contain annotated decls that are traversed in fast mode, so clang doesn't have to parse them
+    if (ASTFileParser::fastTraversal) {
+        compilerInstance.getFrontendOpts().SkipFunctionBodies = true;
+    }
+
+    return clang::SyntaxOnlyAction::BeginInvocation(compilerInstance);
 }
 
 std::unique_ptr<clang::ASTConsumer>
 ASTFrontendAction::CreateASTConsumer(clang::CompilerInstance &compilerInstance, llvm::StringRef inFile) {
     std::cout << "Parsing file: " << inFile.str() << std::endl;
-    return std::make_unique<ASTConsumer>();
+    return std::make_unique<ASTConsumer>(traversalTime);
+}
+
+void ASTFrontendAction::EndSourceFileAction() {
+    //the traversal runs inside the action, so it is subtracted to get the time spent in clang itself
+    const auto total = Statistics::Clock::now() - start;
+    Statistics::AddFile(getCurrentFile().str(), total - traversalTime, traversalTime);
+
+    clang::SyntaxOnlyAction::EndSourceFileAction();
+}
+
+void ASTConsumer::ReportCounters(llvm::ArrayRef<ASTFileParser> parsers) {
+    Statistics::Counters counters{};
+    for (const auto &parser: parsers) {
+        counters.declsVisited += parser.decls_visited;
+        counters.declsSkipped += parser.decls_skipped;
+        counters.declsSkippedByFileID += parser.decls_skipped_by_file_id;
+        counters.annotatedEntities += parser.annotated_entities;
+        counters.skippedParameters += parser.skipped_parameters;
+    }
+    Statistics::AddCounters(counters);
+
+    std::cout << "Skipped " << counters.skippedParameters << " parameters, This is likely due to a function pointer" << std::endl;
 }
 
 void ASTConsumer::HandleTranslationUnit(clang::ASTContext &context) {
+    const auto start = Statistics::Clock::now();
+
+    if (!ASTFileParser::unityHeaders.empty()) {
+        HandleUnityTranslationUnit(context);
+        traversalTime += Statistics::Clock::now() - start;
+        return;
+    }
+
     auto path = context.getSourceManager().getFileEntryRefForID(context.getSourceManager().getMainFileID())->getName();
 
     ASTFileParser parser{path.str()};
+    parser.SetMainFile(context.getSourceManager(), context.getSourceManager().getMainFileID());
+
+    if (ASTFileParser::fastTraversal) {
+        //only visit the top level decls of the header itself, everything it includes is skipped without traversal
+        const auto &sourceManager = context.getSourceManager();
+        const auto mainFileID = sourceManager.getMainFileID();
+
+        for (auto *decl: context.getTranslationUnitDecl()->decls()) {
+            if (sourceManager.getFileID(sourceManager.getExpansionLoc(decl->getLocation())) == mainFileID) {
+                parser.TraverseDecl(decl);
+            }
+        }
+    } else {
+        parser.TraverseDecl(context.getTranslationUnitDecl());
+    }
 
-    parser.TraverseDecl(context.getTranslationUnitDecl());
-    
-    std::cout << "Skipped " << parser.skipped_parameters << " parameters, This is likely due to a function pointer" << std::endl;
+    parser.dependencies = GetDependencies(GetIncludeGraph(context.getSourceManager()),
+                                          ASTFileParser::NormalizePath(parser.path), ASTFileParser::projectHeaders);
 
-    //test if parser has any classes, variables, or functions
-    if (parser.classes.empty() && parser.variables.empty() && parser.functions.empty()) {
-        return;
-    }
+    traversalTime += Statistics::Clock::now() - start;
+    ReportCounters(parser);
 
+    //empty parsers are kept as well, so the cache knows the file was parsed
+    std::lock_guard lock{ASTFileParser::parsersMutex};
     ASTFileParser::parsers.emplace_back(std::move(parser));
 }
+
+void ASTConsumer::HandleUnityTranslationUnit(clang::ASTContext &context) {
+    const auto &sourceManager = context.getSourceManager();
+
+    //one parser per project header, created when the first decl of that header is found
+    std::vector<ASTFileParser> fileParsers{};
+    std::unordered_map<std::string, size_t> headerIndices{};
+    //cache the result per FileID so the file name only has to be looked up once per file
+    llvm::DenseMap<clang::FileID, size_t> fileIndices{};
+    constexpr size_t notAProjectHeader = std::numeric_limits<size_t>::max();
+
+    for (auto *decl: context.getTranslationUnitDecl()->decls()) {
+        const auto fileID = sourceManager.getFileID(sourceManager.getExpansionLoc(decl->getLocation()));
+
+        auto it = fileIndices.find(fileID);
+        if (it == fileIndices.end()) {
+            size_t index = notAProjectHeader;
+
+            const auto fileEntryRef = sourceManager.getFileEntryRefForID(fileID);
+            if (fileEntryRef.has_value()) {
+                const auto name = ASTFileParser::NormalizePath(fileEntryRef->getName().str());
+                if (ASTFileParser::unityHeaders.count(name) != 0) {
+                    //a header without include guards can have multiple FileIDs, reuse the parser of the header
+                    const auto header = headerIndices.try_emplace(name, notAProjectHeader);
+                    //a header reached by multiple translation units is only parsed by the first one to claim it
+                    if (header.second && ASTFileParser::ClaimHeader(name)) {
+                        header.first->second = fileParsers.size();
+                        fileParsers.emplace_back(fileEntryRef->getName().str()).SetMainFile(sourceManager, fileID);
+                    }
+                    index = header.first->second;
+                }
+            }
+
+            it = fileIndices.try_emplace(fileID, index).first;
+        }
+
+        if (it->second == notAProjectHeader) {
+            continue;
+        }
+
+        fileParsers[it->second].TraverseDecl(decl);
+    }
+
+    ReportCounters(fileParsers);
+
+    const auto graph = GetIncludeGraph(sourceManager);
+
+    //headers without any top level decls still get a (empty) parser, so the cache knows they were parsed
+    for (const auto &[includer, includes]: graph) {
+        for (const auto &include: includes) {
+            if (ASTFileParser::unityHeaders.count(include) == 0) {
+                continue;
+            }
+
+            const auto header = headerIndices.try_emplace(include, notAProjectHeader);
+            if (header.second && ASTFileParser::ClaimHeader(include)) {
+                header.first->second = fileParsers.size();
+                fileParsers.emplace_back(include);
+            }
+        }
+    }
+
+    std::lock_guard lock{ASTFileParser::parsersMutex};
+    for (auto &parser: fileParsers) {
+        parser.dependencies = GetDependencies(graph, ASTFileParser::NormalizePath(parser.path),
+                                              ASTFileParser::projectHeaders);
+        ASTFileParser::parsers.emplace_back(std::move(parser));
+    }
+}
@@ -0,0 +1,149 @@
+#include "FileWatcher.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+namespace {
+    //editors often save a file in multiple steps, events within this window are reported together
+    constexpr int debounceMilliseconds = 100;
+}
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path> &directories) {
+    descriptor = inotify_init1(IN_CLOEXEC);
+    if (descriptor < 0) {
+        throw std::runtime_error("Could not initialize inotify");
+    }
+
+    for (const auto &directory: directories) {
+        //saving through a temporary file shows up as a move, so moves are watched as well
+        const int watch = inotify_add_watch(descriptor, directory.c_str(),
+                                            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE);
+        if (watch < 0) {
+            std::cerr << "Warning: could not watch " << directory << std::endl;
+            continue;
+        }
+
+        watches.emplace(watch, directory);
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+}
+
+std::vector<std::filesystem::path> FileWatcher::Wait() {
+    std::vector<std::filesystem::path> changes{};
+
+    alignas(inotify_event) char buffer[4096];
+    //block until the first event, afterward only wait for the debounce window
+    int timeout = -1;
+
+    while (true) {
+        pollfd request{descriptor, POLLIN, 0};
+        const int ready = poll(&request, 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            break;
+        }
+
+        const auto length = read(descriptor, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        for (const char *pointer = buffer; pointer < buffer + length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(pointer);
+
+            const auto watch = watches.find(event->wd);
+            if (event->len > 0 && watch != watches.end()) {
+                changes.emplace_back(watch->second / event->name);
+            }
+
+            pointer += sizeof(inotify_event) + event->len;
+        }
+
+        timeout = debounceMilliseconds;
+    }
+
+    std::sort(changes.begin(), changes.end());
+    changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+    return changes;
+}
+
+#else
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path> &directories) : directories(directories) {
+    Scan();
+}
+
+FileWatcher::~FileWatcher() = default;
+
+std::vector<std::filesystem::path> FileWatcher::Scan() {
+    std::vector<std::filesystem::path> changes{};
+    std::unordered_map<std::string, std::filesystem::file_time_type> current{};
+
+    for (const auto &directory: directories) {
+        std::error_code error{};
+        for (const auto &entry: std::filesystem::directory_iterator{directory, error}) {
+            if (!entry.is_regular_file(error)) {
+                continue;
+            }
+
+            const auto time = entry.last_write_time(error);
+            const auto it = timestamps.find(entry.path().string());
+            if (it == timestamps.end() || it->second != time) {
+                changes.emplace_back(entry.path());
+            }
+
+            current.emplace(entry.path().string(), time);
+        }
+    }
+
+    //files that disappeared changed as well
+    for (const auto &[file, time]: timestamps) {
+        if (current.count(file) == 0) {
+            changes.emplace_back(file);
+        }
+    }
+
+    timestamps = std::move(current);
+    return changes;
+}
+
+std::vector<std::filesystem::path> FileWatcher::Wait() {
+    std::vector<std::filesystem::path> changes{};
+
+    //poll until the first change, then collect the changes within the debounce window
+    while (changes.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(debounceMilliseconds * 5));
+        changes = Scan();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(debounceMilliseconds));
+    for (auto &change: Scan()) {
+        changes.emplace_back(std::move(change));
+    }
+
+    std::sort(changes.begin(), changes.end());
+    changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+    return changes;
+}
+
+#endif
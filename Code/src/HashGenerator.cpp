@@ -0,0 +1,114 @@
+#include "HashGenerator.hpp"
+
+namespace {
+    //whether a run of trivially copyable members can be compared as bytes is decided by the compiler
+    std::string GetSpan(const std::string &type, const MemberRun &run) {
+        const auto &first = run.members.front()->name;
+        const auto &last = run.members.back()->name;
+        return "offsetof(" + type + ", " + last + ") + sizeof(" + type + "::" + last + ") - offsetof(" + type + ", " +
+               first + ")";
+    }
+
+    std::string GetPackedCondition(const std::string &type, const MemberRun &run) {
+        std::string members{};
+        for (const auto *member: run.members) {
+            if (!members.empty()) {
+                members += ", ";
+            }
+            members += "decltype(" + type + "::" + member->name + ")";
+        }
+        return "CodeGenerator::IsPackedRun<" + members + ">(" + GetSpan(type, run) + ")";
+    }
+
+    //the statements for a run, the byte-wise statement if the run is packed, otherwise one statement per member
+    template<typename Packed, typename Member>
+    void WriteRuns(std::vector<std::string> &header, const std::string &type, const std::vector<MemberRun> &runs,
+                   const std::string &indent, Packed packed, Member member) {
+        for (const auto &run: runs) {
+            if (run.members.size() == 1) {
+                member(indent, *run.members.front());
+                continue;
+            }
+
+            header.emplace_back(indent + "if constexpr (" + GetPackedCondition(type, run) + ") {");
+            packed(indent + "    ", run);
+            header.emplace_back(indent + "} else {");
+            for (const auto *variable: run.members) {
+                member(indent + "    ", *variable);
+            }
+            header.emplace_back(indent + "}");
+        }
+    }
+}
+
+void HashGenerator::HandleClass(FileGenerator &fileGenerator, const Class &class_) {
+    if (!class_.HasProperty(PropertyKeys::Hashable) || !FileGenerator::IsNameable(class_)) {
+        return;
+    }
+
+    const auto type = "::" + class_.fullNamespace;
+    const auto runs = FileGenerator::GetMemberRuns(class_, "Hasher");
+
+    auto &header = FileGenerator::BeginSpecialization(GetFileName(class_), class_, "CodeGenerator/Hash.hpp");
+    header.emplace_back("    struct Hasher<" + type + "> {");
+    header.emplace_back("        static uint64_t Hash(const " + type + " &object) {");
+    header.emplace_back("            uint64_t hash = 0;");
+    WriteRuns(header, type, runs, "            ",
+              [&header, &type](const std::string &indent, const MemberRun &run) {
+                  header.emplace_back(indent + "hash = HashBytes(&object." + run.members.front()->name + ", " +
+                                      GetSpan(type, run) + ", hash);");
+              },
+              [&header](const std::string &indent, const Variable &variable) {
+                  header.emplace_back(indent + "hash = CombineHashes(hash, CodeGenerator::Hash(object." +
+                                      variable.name + "));");
+              });
+    header.emplace_back("            return hash;");
+    header.emplace_back("        }");
+    header.emplace_back("    };");
+    header.emplace_back("}");
+    header.emplace_back("");
+
+    //the operators are found by argument dependent lookup, so they have to be in the namespace of the class
+    const bool global = class_.enclosingNamespace.empty();
+    const std::string indent = global ? "    " : "        ";
+    if (!global) {
+        header.emplace_back("namespace " + class_.enclosingNamespace + " {");
+    }
+    header.emplace_back(indent.substr(4) + "inline bool operator==(const " + type + " &a, const " + type + " &b) {");
+    WriteRuns(header, type, runs, indent,
+              [&header, &type](const std::string &indent, const MemberRun &run) {
+                  const auto &name = run.members.front()->name;
+                  header.emplace_back(indent + "if (std::memcmp(&a." + name + ", &b." + name + ", " +
+                                      GetSpan(type, run) + ") != 0) {");
+                  header.emplace_back(indent + "    return false;");
+                  header.emplace_back(indent + "}");
+              },
+              [&header](const std::string &indent, const Variable &variable) {
+                  header.emplace_back(indent + "if (!CodeGenerator::Equal(a." + variable.name + ", b." +
+                                      variable.name + ")) {");
+                  header.emplace_back(indent + "    return false;");
+                  header.emplace_back(indent + "}");
+              });
+    header.emplace_back(indent + "return true;");
+    header.emplace_back(indent.substr(4) + "}");
+    header.emplace_back("");
+    header.emplace_back(indent.substr(4) + "inline bool operator!=(const " + type + " &a, const " + type + " &b) {");
+    header.emplace_back(indent + "return !(a == b);");
+    header.emplace_back(indent.substr(4) + "}");
+    if (!global) {
+        header.emplace_back("}");
+    }
+    header.emplace_back("");
+
+    header.emplace_back("template<>");
+    header.emplace_back("struct std::hash<" + type + "> {");
+    header.emplace_back("    size_t operator()(const " + type + " &object) const noexcept {");
+    header.emplace_back("        return static_cast<size_t>(CodeGenerator::Hash(object));");
+    header.emplace_back("    }");
+    header.emplace_back("};");
+    FileGenerator::EndSpecialization(header, class_);
+}
+
+std::string HashGenerator::GetFileName(const Object &object) {
+    return "Hash/" + FileGenerator::GetIdentifier(object) + ".gen.hpp";
+}
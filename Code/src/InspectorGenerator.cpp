@@ -0,0 +1,145 @@
+#include "InspectorGenerator.hpp"
+
+#include <CodeGenerator/Inspector.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <optional>
+
+namespace {
+    //seeds tried per bucket before giving up, buckets with a few names find one within the first hundred
+    constexpr uint64_t maximumSeed = 1u << 20;
+
+    struct PerfectHash {
+        std::vector<uint64_t> seeds;
+        //the index of the member in every slot
+        std::vector<size_t> slots;
+    };
+
+    //hash and displace: the names are split into buckets by their hash, then every bucket, the largest first,
+    //gets the first seed that moves all of its names into free slots
+    std::optional<PerfectHash> FindPerfectHash(const std::vector<const Variable *> &members) {
+        const auto count = members.size();
+        const auto bucketCount = std::max<size_t>(1, count / 2);
+
+        std::vector<uint64_t> hashes{};
+        std::vector<std::vector<size_t>> buckets(bucketCount);
+        for (size_t i = 0; i < count; ++i) {
+            hashes.emplace_back(CodeGenerator::Fnv1a(members[i]->name));
+            buckets[CodeGenerator::GetPerfectHashBucket(hashes.back(), bucketCount)].emplace_back(i);
+        }
+
+        std::vector<size_t> order(bucketCount);
+        for (size_t i = 0; i < bucketCount; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        PerfectHash result{std::vector<uint64_t>(bucketCount, 0), std::vector<size_t>(count, count)};
+        std::vector<size_t> candidates{};
+        for (const auto bucket: order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+
+            bool placed = false;
+            for (uint64_t seed = 0; seed < maximumSeed && !placed; ++seed) {
+                candidates.clear();
+                for (const auto member: buckets[bucket]) {
+                    const auto slot = CodeGenerator::GetPerfectHashSlot(hashes[member], seed, count);
+                    if (result.slots[slot] != count ||
+                        std::find(candidates.begin(), candidates.end(), slot) != candidates.end()) {
+                        break;
+                    }
+                    candidates.emplace_back(slot);
+                }
+
+                if (candidates.size() == buckets[bucket].size()) {
+                    for (size_t i = 0; i < candidates.size(); ++i) {
+                        result.slots[candidates[i]] = buckets[bucket][i];
+                    }
+                    result.seeds[bucket] = seed;
+                    placed = true;
+                }
+            }
+
+            if (!placed) {
+                return std::nullopt;
+            }
+        }
+
+        return result;
+    }
+}
+
+void InspectorGenerator::HandleClass(FileGenerator &fileGenerator, const Class &class_) {
+    //the same members LuaGenerator::HandleMember adds to the usertype
+    if (!class_.HasProperty(PropertyKeys::LuaClass) || !FileGenerator::IsNameable(class_)) {
+        return;
+    }
+
+    std::vector<const Variable *> members{};
+    for (const auto &variable: class_.variables) {
+        if (!variable.HasProperty(PropertyKeys::LuaInspect)) {
+            continue;
+        }
+        if (!FileGenerator::IsAccessible(class_, variable, "Inspector")) {
+            continue;
+        }
+        //bit-fields can't be passed by reference to the visitor
+        if (variable.isBitField) {
+            std::cerr << "Warning: " << class_.fullNamespace << "::" << variable.name
+                      << " is a bit-field, it can't be inspected by name" << std::endl;
+            continue;
+        }
+        members.emplace_back(&variable);
+    }
+    if (members.empty()) {
+        return;
+    }
+
+    const auto perfectHash = FindPerfectHash(members);
+    if (!perfectHash) {
+        std::cerr << "Warning: no perfect hash found for the members of " << class_.fullNamespace << std::endl;
+        return;
+    }
+
+    const auto type = "::" + class_.fullNamespace;
+
+    auto &header = FileGenerator::BeginSpecialization(GetFileName(class_), class_, "CodeGenerator/Inspector.hpp");
+    header.emplace_back("    struct Inspector<" + type + "> {");
+
+    std::string seeds{};
+    for (const auto seed: perfectHash->seeds) {
+        seeds += (seeds.empty() ? "" : ", ") + std::to_string(seed) + "ull";
+    }
+    header.emplace_back("        static constexpr std::array<uint64_t, " + std::to_string(perfectHash->seeds.size()) +
+                        "> seeds{{" + seeds + "}};");
+    header.emplace_back("        static constexpr std::array<std::string_view, " + std::to_string(members.size()) +
+                        "> names{{");
+    for (const auto member: perfectHash->slots) {
+        header.emplace_back("            \"" + members[member]->name + "\",");
+    }
+    header.emplace_back("        }};");
+    header.emplace_back("");
+    header.emplace_back("        template<typename Object, typename Function>");
+    header.emplace_back("        static bool Visit(Object &object, size_t slot, Function &&function) {");
+    header.emplace_back("            switch (slot) {");
+    for (size_t slot = 0; slot < perfectHash->slots.size(); ++slot) {
+        header.emplace_back("                case " + std::to_string(slot) + ":");
+        header.emplace_back("                    return function(object." + members[perfectHash->slots[slot]]->name + ");");
+    }
+    header.emplace_back("                default:");
+    header.emplace_back("                    return false;");
+    header.emplace_back("            }");
+    header.emplace_back("        }");
+    header.emplace_back("    };");
+    header.emplace_back("}");
+    FileGenerator::EndSpecialization(header, class_);
+}
+
+std::string InspectorGenerator::GetFileName(const Object &object) {
+    return "Inspector/" + FileGenerator::GetIdentifier(object) + ".gen.hpp";
+}
@@ -0,0 +1,159 @@
+#include "LuaGenerator.hpp"
+
+#include <iostream>
+
+const Class *LuaGenerator::currentClass = nullptr;
+std::map<std::string, std::string> LuaGenerator::registrars{};
+bool LuaGenerator::eagerRegistration = false;
+
+std::string LuaGenerator::GetRegistrarName(const Class &class_) {
+    return "RegisterLua_" + FileGenerator::GetIdentifier(class_);
+}
+
+bool LuaGenerator::IsRegistered(const Class &class_) {
+    const auto it = registrars.find(class_.name);
+    return it != registrars.end() && it->second == GetRegistrarName(class_);
+}
+
+void LuaGenerator::Reset() {
+    currentClass = nullptr;
+    registrars.clear();
+}
+
+void LuaGenerator::HandleClass(FileGenerator &fileGenerator, const Class &class_) {
+    currentClass = &class_;
+
+    if (class_.HasProperty(PropertyKeys::LuaClass)) {
+        const auto registrar = GetRegistrarName(class_);
+        //both classes would be the same global in Lua
+        const auto [it, inserted] = registrars.emplace(class_.name, registrar);
+        if (!inserted && it->second != registrar) {
+            std::cerr << "Warning: " << class_.fullNamespace << " is not registered in Lua, the name " << class_.name
+                      << " is already used by another LuaClass" << std::endl;
+            return;
+        }
+
+        auto &file = FileGenerator::files[fileName];
+        file.includes.insert(class_.path);
+        file.shardable.insert(registrar);
+
+        auto &function = file.functions[registrar];
+        function.includes.insert(class_.path);
+        function.header.AddVariable({"sol::state_view", "lua_state"});
+
+        auto &body = function.body;
+        std::string userTypeCreation =
+                "    sol::usertype<" + class_.fullNamespace + "> " + class_.name + "_table = lua_state.new_usertype<" +
+                class_.fullNamespace + ">(\"" + class_.name + "\", sol::constructors<" + class_.fullNamespace +
+                "()>{});";
+
+        body.emplace_back(userTypeCreation);
+    }
+}
+
+void LuaGenerator::HandleMember(FileGenerator &fileGenerator, const Variable &variable) {
+    //members can only be added to the usertype of a registered LuaClass
+    if (variable.HasProperty(PropertyKeys::LuaInspect) && IsRegistered(*currentClass)) {
+        FileGenerator::files[fileName].includes.insert(variable.path);
+        auto &function = FileGenerator::files[fileName].functions[GetRegistrarName(*currentClass)];
+        function.includes.insert(variable.path);
+
+        auto &body = function.body;
+        std::string propertyCreation =
+                "    " + currentClass->name + "_table[\"" + variable.name + "\"] = &" + variable.fullNamespace + ";";
+        body.emplace_back(propertyCreation);
+    }
+}
+
+void LuaGenerator::HandleMethod(FileGenerator &fileGenerator, const Function &function) {
+    //methods can only be added to the usertype of a registered LuaClass
+    if (function.HasProperty(PropertyKeys::LuaInspect) && IsRegistered(*currentClass)) {
+        FileGenerator::files[fileName].includes.insert(function.path);
+        auto &fullFunction = FileGenerator::files[fileName].functions[GetRegistrarName(*currentClass)];
+        fullFunction.includes.insert(function.path);
+
+        auto &body = fullFunction.body;
+        std::string propertyCreation =
+                "    " + currentClass->name + "_table[\"" + function.name + "\"] = &" + function.fullNamespace + ";";
+        body.emplace_back(propertyCreation);
+    }
+}
+
+void LuaGenerator::WriteBindings() {
+    if (registrars.empty()) {
+        return;
+    }
+
+    auto &file = FileGenerator::files[fileName];
+
+    file.header.clear();
+    file.header.emplace_back("#include <algorithm>");
+    file.header.emplace_back("#include <iterator>");
+    file.header.emplace_back("#include <string_view>");
+    file.header.emplace_back("#include <utility>");
+
+    //LuaBindings.cpp.gen is included after sol by the project, shards are compiled on their own
+    file.shardHeader = {"#include <sol/sol.hpp>"};
+
+    auto &function = file.functions["CreateBindings"];
+    function.header.AddVariable({"sol::state&", "lua_state"});
+
+    //the registration functions are written after CreateBindings or in shards, declare them first
+    //the declarations are not part of the header, so a shard doesn't change when a class is added to another shard
+    function.prefix.clear();
+    for (const auto &[name, registrar]: registrars) {
+        function.prefix += "void " + registrar + "(sol::state_view lua_state);\n";
+    }
+    function.prefix += '\n';
+
+    auto &body = function.body;
+    body.clear();
+
+    if (eagerRegistration) {
+        for (const auto &[name, registrar]: registrars) {
+            body.emplace_back("    " + registrar + "(lua_state);");
+        }
+        return;
+    }
+
+    //reading a global that doesn't exist calls __index of the globals, which registers the usertype once,
+    //afterwards the global exists and lookups don't reach __index anymore
+    body.emplace_back("    //sorted by name, a usertype is registered the first time a script reads its global");
+    body.emplace_back("    static constexpr std::pair<std::string_view, void (*)(sol::state_view)> usertypes[] = {");
+    for (const auto &[name, registrar]: registrars) {
+        body.emplace_back("        {\"" + name + "\", &" + registrar + "},");
+    }
+    body.emplace_back("    };");
+    body.emplace_back("");
+    body.emplace_back("    //an existing metatable of the globals is kept, names that aren't usertypes are passed to its __index");
+    body.emplace_back("    sol::table globalTable = lua_state.globals();");
+    body.emplace_back("    auto existing = globalTable[sol::metatable_key].get<sol::optional<sol::table>>();");
+    body.emplace_back("    sol::table metatable = existing ? *existing : lua_state.create_table();");
+    body.emplace_back("    sol::object previous = metatable.raw_get<sol::object>(sol::meta_function::index);");
+    body.emplace_back("");
+    body.emplace_back("    metatable[sol::meta_function::index] = [previous](sol::this_state state, sol::table globals, sol::object key) -> sol::object {");
+    body.emplace_back("        if (key.get_type() == sol::type::string) {");
+    body.emplace_back("            const auto name = key.as<std::string_view>();");
+    body.emplace_back("            const auto it = std::lower_bound(std::begin(usertypes), std::end(usertypes), name, [](const auto &usertype, std::string_view name) {");
+    body.emplace_back("                return usertype.first < name;");
+    body.emplace_back("            });");
+    body.emplace_back("            if (it != std::end(usertypes) && it->first == name) {");
+    body.emplace_back("                it->second(sol::state_view{state});");
+    body.emplace_back("                return globals.raw_get<sol::object>(it->first);");
+    body.emplace_back("            }");
+    body.emplace_back("        }");
+    body.emplace_back("");
+    body.emplace_back("        //__index is either a function or a table, like in Lua itself");
+    body.emplace_back("        if (previous.get_type() == sol::type::function) {");
+    body.emplace_back("            sol::object result = previous.as<sol::function>()(globals, key);");
+    body.emplace_back("            return result;");
+    body.emplace_back("        }");
+    body.emplace_back("        if (previous.get_type() == sol::type::table) {");
+    body.emplace_back("            return previous.as<sol::table>().get<sol::object>(key);");
+    body.emplace_back("        }");
+    body.emplace_back("        return sol::lua_nil;");
+    body.emplace_back("    };");
+    body.emplace_back("    if (!existing) {");
+    body.emplace_back("        globalTable[sol::metatable_key] = metatable;");
+    body.emplace_back("    }");
+}
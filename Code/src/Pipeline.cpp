@@ -0,0 +1,151 @@
+#include "Pipeline.hpp"
+#include "FileGenerator.hpp"
+#include "FileParser.hpp"
+#include "HashGenerator.hpp"
+#include "InspectorGenerator.hpp"
+#include "LuaGenerator.hpp"
+#include "ReflectionGenerator.hpp"
+#include "SerializationGenerator.hpp"
+#include "SoAGenerator.hpp"
+#include "Statistics.hpp"
+#include "ToolRunner.hpp"
+
+#include <iostream>
+
+std::vector<std::string> Pipeline::GetCompileArguments() {
+    //construct command line arguments for clang
+    //TODO: make this dynamic, for now they will be hard coded
+    std::vector<std::string> args{};
+    //clang should work on all files in the headers vector
+    //clang should only create the AST, not compile the files
+    //clang should only care about the provided headers
+    //clang should only care about definitions, not function bodies
+    //clang should use the C++17 standard
+    args.emplace_back("clang");
+    args.emplace_back("-fsyntax-only");
+    args.emplace_back("-std=c++17");
+    args.emplace_back("-IC:/Program Files/Microsoft Visual Studio/2022/Community/VC/Tools/MSVC/14.38.33130/include");
+
+    return args;
+}
+
+void Pipeline::ExtractHeaders(const Options &options, SimpleOptionParser &optionParser,
+                              const std::vector<std::filesystem::path> &headers,
+                              const std::filesystem::path &output_directory,
+                              const std::vector<std::filesystem::path> &sources) {
+    if (headers.empty()) {
+        return;
+    }
+
+    optionParser.SetHeaders(headers);
+
+    if (options.prescan) {
+        const auto pruned = optionParser.PruneUnannotatedHeaders();
+        std::cout << "Skipping " << pruned << " of " << headers.size() << " headers without markers" << std::endl;
+
+        if (pruned == headers.size()) {
+            return;
+        }
+    }
+
+    //precompile the shared includes once, every header will load them from the precompiled header
+    if (!options.prelude.empty() && optionParser.GetPrecompiledHeader().empty()) {
+        //the precompiled header must not be injected while it is being built
+        const auto precompiledHeader = output_directory / "CodeGenerator.pch";
+        std::vector<std::string> inputs{};
+        if (ToolRunner::BuildPrecompiledHeader(optionParser, options.prelude, precompiledHeader, inputs) == 0) {
+            optionParser.SetPrecompiledHeader(precompiledHeader, std::move(inputs));
+        } else {
+            std::cerr << "Warning: could not precompile " << options.prelude << ", continuing without it" << std::endl;
+        }
+    }
+
+    //compile the sources first, every project header they include is parsed by the first source that reaches it
+    //a header included by many others is parsed once instead of once per includer, so this is done even when
+    //there are more sources than outdated headers, see Options::sources
+    if (options.sources && !sources.empty()) {
+        std::vector<std::string> sourceFiles{};
+        sourceFiles.reserve(sources.size());
+        for (const auto &source: sources) {
+            sourceFiles.emplace_back(source.string());
+        }
+
+        const auto files = optionParser.getAllFiles();
+        ASTFileParser::SetUnityHeaders(std::vector<std::filesystem::path>(files.begin(), files.end()));
+        ToolRunner::Run(optionParser, sourceFiles, options.jobs);
+
+        std::vector<std::filesystem::path> remaining{};
+        for (const auto &file: files) {
+            if (!ASTFileParser::IsHeaderClaimed(file)) {
+                remaining.emplace_back(file);
+            }
+        }
+        ASTFileParser::SetUnityHeaders({});
+
+        std::cout << "Sources reached " << files.size() - remaining.size() << " of " << files.size()
+                  << " headers, parsing the remaining headers on their own" << std::endl;
+        if (remaining.empty()) {
+            return;
+        }
+        optionParser.SetHeaders(remaining);
+    }
+
+    //run the tool
+    if (options.unity) {
+        //one unity translation unit per thread, so the standard library is only parsed once per thread
+        const auto unitySources = optionParser.GetUnitySources(ToolRunner::GetJobCount(options.jobs));
+
+        std::vector<std::string> unityFiles{};
+        for (const auto &source: unitySources) {
+            unityFiles.emplace_back(source.first);
+        }
+
+        //only the headers that survived the prescan are attributed decls
+        const auto files = optionParser.getAllFiles();
+        ASTFileParser::SetUnityHeaders(std::vector<std::filesystem::path>(files.begin(), files.end()));
+        ToolRunner::Run(optionParser, unityFiles, options.jobs, unitySources);
+    } else {
+        ToolRunner::Run(optionParser, optionParser.getAllFiles(), options.jobs);
+    }
+}
+
+void Pipeline::GenerateFiles(const Options &options, const std::vector<std::filesystem::path> &headers) {
+    //cached and parsed headers are mixed, restore the order of the project
+    std::vector<std::string> headerOrder{};
+    headerOrder.reserve(headers.size());
+    for (const auto &header: headers) {
+        headerOrder.emplace_back(header.string());
+    }
+    ASTFileParser::SortParsers(headerOrder);
+
+    //start from scratch, the files of a previous run would otherwise be generated twice
+    FileGenerator::files.clear();
+    LuaGenerator::Reset();
+    LuaGenerator::SetEagerRegistration(options.eagerLua);
+    FileGenerator::shardCount = options.shards;
+
+    FileGenerator File{};
+
+    File.ParseClass = [](FileGenerator &fileGenerator, const Class &class_) {
+        LuaGenerator::HandleClass(fileGenerator, class_);
+        ReflectionGenerator::HandleClass(fileGenerator, class_);
+        SerializationGenerator::HandleClass(fileGenerator, class_);
+        SoAGenerator::HandleClass(fileGenerator, class_);
+        HashGenerator::HandleClass(fileGenerator, class_);
+        InspectorGenerator::HandleClass(fileGenerator, class_);
+    };
+    File.ParseMember = LuaGenerator::HandleMember;
+    File.ParseEnum = ReflectionGenerator::HandleEnum;
+    File.ParseMethod = LuaGenerator::HandleMethod;
+
+    {
+        Statistics::ScopedTimer timer{Statistics::Phase::Generate};
+        for (const auto &parser: ASTFileParser::GetParsers()) {
+            File.Parse(parser);
+        }
+        LuaGenerator::WriteBindings();
+    }
+
+    Statistics::ScopedTimer timer{Statistics::Phase::Write};
+    FileGenerator::WriteFiles();
+}
@@ -0,0 +1,75 @@
+#include "PropertyKey.hpp"
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    //the names of the keys in PropertyKeys, in the same order
+    constexpr std::array<std::string_view, 13> knownNames{
+            "", "CGCLASS", "CGMEMBER", "CGMETHOD", "CGFUNCTION", "CGVARIABLE", "CGCONSTRUCTOR", "LuaClass", "LuaInspect",
+            "CGENUM", "Serialize", "SoA", "Hashable"
+    };
+
+    struct SymbolTable {
+        std::shared_mutex mutex;
+        //a deque never moves its elements, so views of the names stay valid while names are added
+        std::deque<std::string> names;
+        std::unordered_map<std::string_view, uint32_t> ids;
+
+        SymbolTable() {
+            for (const auto &name: knownNames) {
+                const auto id = static_cast<uint32_t>(names.size());
+                ids.emplace(names.emplace_back(name), id);
+            }
+        }
+    };
+
+    //constructed on first use, so keys can be interned during static initialization as well
+    SymbolTable &GetSymbolTable() {
+        static SymbolTable table{};
+        return table;
+    }
+}
+
+PropertyKey PropertyKey::Intern(std::string_view name) {
+    auto &table = GetSymbolTable();
+
+    //almost every name is already known, only take the exclusive lock when a name is added
+    {
+        std::shared_lock lock{table.mutex};
+        const auto it = table.ids.find(name);
+        if (it != table.ids.end()) {
+            return PropertyKey{it->second};
+        }
+    }
+
+    std::unique_lock lock{table.mutex};
+    //another thread may have added the name in between the locks
+    const auto it = table.ids.find(name);
+    if (it != table.ids.end()) {
+        return PropertyKey{it->second};
+    }
+
+    const auto id = static_cast<uint32_t>(table.names.size());
+    table.ids.emplace(table.names.emplace_back(name), id);
+    return PropertyKey{id};
+}
+
+PropertyKey PropertyKey::Find(std::string_view name) {
+    auto &table = GetSymbolTable();
+
+    std::shared_lock lock{table.mutex};
+    const auto it = table.ids.find(name);
+    return it != table.ids.end() ? PropertyKey{it->second} : PropertyKey{};
+}
+
+std::string_view PropertyKey::GetName() const {
+    auto &table = GetSymbolTable();
+
+    std::shared_lock lock{table.mutex};
+    return id < table.names.size() ? std::string_view{table.names[id]} : std::string_view{};
+}
@@ -0,0 +1,176 @@
+#include "PropertyParser.hpp"
+
+namespace {
+    bool IsWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool IsWordCharacter(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '_' || c == ':' || c == '.' || c == '+' || c == '-';
+    }
+
+    //recursive descent over the text, every character is looked at once
+    class Parser {
+        std::string_view text;
+        size_t position = 0;
+    public:
+        std::optional<PropertyParser::Error> error{};
+
+        explicit Parser(std::string_view text) : text(text) {};
+
+        [[nodiscard]] size_t GetPosition() const {
+            return position;
+        };
+
+        void SkipWhitespace() {
+            while (position < text.size() && IsWhitespace(text[position])) {
+                ++position;
+            }
+        };
+
+        bool Fail(size_t at, std::string message) {
+            error = PropertyParser::Error{at, std::move(message)};
+            return false;
+        };
+
+        //parses properties until the end of the text or the closing character, which is not consumed
+        bool ParseList(std::vector<Property> &properties, char closing) {
+            SkipWhitespace();
+
+            while (position < text.size() && text[position] != closing) {
+                if (!ParseProperty(properties.emplace_back())) {
+                    properties.pop_back();
+                    return false;
+                }
+
+                SkipWhitespace();
+                if (position >= text.size() || text[position] == closing) {
+                    break;
+                }
+                if (text[position] != ',') {
+                    return Fail(position, std::string{"expected ',' or '"} + closing + "'");
+                }
+
+                ++position;
+                SkipWhitespace();
+            }
+
+            return true;
+        };
+
+        bool ParseProperty(Property &property) {
+            if (!ParseText(property.name)) {
+                return error.has_value() ? false : Fail(position, "expected a property name");
+            }
+            property.key = PropertyKey::Intern(property.name);
+
+            SkipWhitespace();
+            if (position >= text.size() || text[position] != '=') {
+                property.value = std::string{};
+                return true;
+            }
+
+            ++position;
+            SkipWhitespace();
+
+            if (position < text.size() && text[position] == '{') {
+                const auto open = position++;
+
+                auto &list = property.value.emplace<std::vector<Property>>();
+                if (!ParseList(list, '}')) {
+                    return false;
+                }
+                if (position >= text.size()) {
+                    return Fail(open, "unterminated list, missing '}'");
+                }
+
+                ++position;
+                return true;
+            }
+
+            auto &value = property.value.emplace<std::string>();
+            if (!ParseText(value)) {
+                return error.has_value() ? false : Fail(position, "expected a value");
+            }
+
+            return true;
+        };
+
+        //parses a word or a string, returns false if there is neither
+        bool ParseText(std::string &result) {
+            if (position >= text.size()) {
+                return false;
+            }
+
+            if (text[position] == '"') {
+                return ParseString(result);
+            }
+
+            const auto start = position;
+            while (position < text.size() && IsWordCharacter(text[position])) {
+                ++position;
+            }
+
+            result.assign(text.data() + start, position - start);
+            return position != start;
+        };
+
+        bool ParseString(std::string &result) {
+            const auto open = position++;
+
+            //most strings have no escapes, copy those in one go
+            auto start = position;
+            while (position < text.size() && text[position] != '"') {
+                if (text[position] != '\\') {
+                    ++position;
+                    continue;
+                }
+
+                result.append(text.data() + start, position - start);
+                if (position + 1 >= text.size()) {
+                    position = text.size();
+                    break;
+                }
+
+                switch (text[position + 1]) {
+                    case 'n':
+                        result += '\n';
+                        break;
+                    case 't':
+                        result += '\t';
+                        break;
+                    case '"':
+                    case '\\':
+                        result += text[position + 1];
+                        break;
+                    default:
+                        return Fail(position, "unknown escape sequence");
+                }
+
+                position += 2;
+                start = position;
+            }
+
+            if (position >= text.size()) {
+                return Fail(open, "unterminated string");
+            }
+
+            result.append(text.data() + start, position - start);
+            ++position;
+            return true;
+        };
+    };
+}
+
+std::optional<PropertyParser::Error> PropertyParser::Parse(std::string_view text, std::vector<Property> &properties,
+                                                           size_t *end) {
+    Parser parser{text};
+    parser.ParseList(properties, ')');
+
+    if (end != nullptr) {
+        *end = parser.GetPosition();
+    }
+
+    return parser.error;
+}
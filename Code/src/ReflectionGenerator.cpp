@@ -0,0 +1,132 @@
+#include "ReflectionGenerator.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace {
+    //enums with at most this many unused values per enumerator get a table indexed by value
+    constexpr uint64_t maximumGapsPerEnumerator = 2;
+
+    //a long long literal, the smallest value has no literal because the minus is applied to the literal after it
+    std::string GetLongLongLiteral(int64_t value) {
+        if (value == std::numeric_limits<int64_t>::min()) {
+            return "(-" + std::to_string(std::numeric_limits<int64_t>::max()) + "ll - 1)";
+        }
+        return std::to_string(value) + "ll";
+    }
+
+    //the value as a literal of the underlying type, so unsigned values above the signed range are restored
+    std::string GetValueLiteral(const Enum &enum_, const Enumerator &enumerator) {
+        return "static_cast<" + enum_.underlyingType + ">(" + GetLongLongLiteral(enumerator.value) + ")";
+    }
+}
+
+void ReflectionGenerator::HandleClass(FileGenerator &fileGenerator, const Class &class_) {
+    if (!FileGenerator::IsNameable(class_)) {
+        return;
+    }
+
+    const auto type = "::" + class_.fullNamespace;
+
+    //the table can only describe members that have an address and an offset the generated file can name
+    std::vector<const Variable *> fields{};
+    if (class_.hasVirtualBases) {
+        std::cerr << "Warning: " << class_.fullNamespace
+                  << " has virtual bases, its members have no fixed offset and aren't reflected" << std::endl;
+    } else {
+        for (const auto &variable: class_.variables) {
+            if (variable.isPublic && !variable.isBitField) {
+                fields.emplace_back(&variable);
+            }
+        }
+    }
+
+    auto &header = FileGenerator::BeginSpecialization(GetFileName(class_), class_, "CodeGenerator/Reflection.hpp");
+    header.emplace_back("    struct Reflection<" + type + "> {");
+    header.emplace_back("        static constexpr std::string_view name = \"" + class_.fullNamespace + "\";");
+    header.emplace_back("        static constexpr std::array<FieldDescriptor, " + std::to_string(fields.size()) +
+                        "> fields{{");
+
+    for (const auto *variable: fields) {
+        const auto member = type + "::" + variable->name;
+        header.emplace_back("            {\"" + variable->name + "\", \"" + variable->type + "\", offsetof(" + type + ", " +
+                            variable->name + "), sizeof(" + member + "), alignof(decltype(" + member +
+                            ")), GetTypeId<decltype(" + member + ")>()},");
+    }
+
+    header.emplace_back("        }};");
+    header.emplace_back("    };");
+    header.emplace_back("}");
+    FileGenerator::EndSpecialization(header, class_);
+}
+
+void ReflectionGenerator::HandleEnum(FileGenerator &fileGenerator, const Enum &enum_) {
+    if (!FileGenerator::IsNameable(enum_)) {
+        return;
+    }
+
+    const auto type = "::" + enum_.fullNamespace;
+    const auto count = std::to_string(enum_.enumerators.size());
+
+    const auto entry = [&type, &enum_](const Enumerator &enumerator) {
+        return "            {\"" + enumerator.name + "\", static_cast<" + type + ">(" +
+               GetValueLiteral(enum_, enumerator) + ")},";
+    };
+
+    std::vector<const Enumerator *> byName{};
+    for (const auto &enumerator: enum_.enumerators) {
+        byName.emplace_back(&enumerator);
+    }
+    //the stable sort keeps aliases in declaration order, so lookups find the first enumerator of a value
+    auto byValue = byName;
+    std::sort(byName.begin(), byName.end(), [](const auto *a, const auto *b) { return a->name < b->name; });
+    std::stable_sort(byValue.begin(), byValue.end(), [](const auto *a, const auto *b) { return a->value < b->value; });
+
+    auto &header = FileGenerator::BeginSpecialization(GetFileName(enum_), enum_, "CodeGenerator/Enum.hpp");
+    header.emplace_back("    struct EnumReflection<" + type + "> {");
+    header.emplace_back("        static constexpr std::string_view name = \"" + enum_.fullNamespace + "\";");
+    header.emplace_back("        static constexpr std::array<EnumEntry<" + type + ">, " + count + "> entries{{");
+    for (const auto *enumerator: byName) {
+        header.emplace_back(entry(*enumerator));
+    }
+    header.emplace_back("        }};");
+
+    //the range is computed unsigned, the difference between the extremes of int64_t doesn't fit a signed integer
+    const auto minimum = byValue.empty() ? 0 : byValue.front()->value;
+    const auto range = byValue.empty() ? 0 : static_cast<uint64_t>(byValue.back()->value) - static_cast<uint64_t>(minimum) + 1;
+    const bool dense = !byValue.empty() && range != 0 && range <= (maximumGapsPerEnumerator + 1) * byValue.size();
+
+    if (dense) {
+        //every value in the range gets a slot, values without an enumerator have an empty name
+        std::vector<std::string> names(range);
+        for (const auto *enumerator: byValue) {
+            auto &name = names[static_cast<uint64_t>(enumerator->value) - static_cast<uint64_t>(minimum)];
+            if (name.empty()) {
+                name = enumerator->name;
+            }
+        }
+
+        header.emplace_back("        static constexpr bool dense = true;");
+        header.emplace_back("        static constexpr int64_t minimum = " + GetLongLongLiteral(minimum) + ";");
+        header.emplace_back("        static constexpr std::array<std::string_view, " + std::to_string(range) + "> names{{");
+        for (const auto &name: names) {
+            header.emplace_back("            \"" + name + "\",");
+        }
+        header.emplace_back("        }};");
+    } else {
+        header.emplace_back("        static constexpr bool dense = false;");
+        header.emplace_back("        static constexpr std::array<EnumEntry<" + type + ">, " + count + "> byValue{{");
+        for (const auto *enumerator: byValue) {
+            header.emplace_back(entry(*enumerator));
+        }
+        header.emplace_back("        }};");
+    }
+
+    header.emplace_back("    };");
+    header.emplace_back("}");
+}
+
+std::string ReflectionGenerator::GetFileName(const Object &object) {
+    return "Reflection/" + FileGenerator::GetIdentifier(object) + ".gen.hpp";
+}
@@ -0,0 +1,89 @@
+#include "SerializationGenerator.hpp"
+
+namespace {
+    //the bytes from the start of the first member to the end of the last, including the padding in between
+    std::string GetRunSize(const std::string &type, const MemberRun &run) {
+        const auto &first = run.members.front()->name;
+        const auto &last = run.members.back()->name;
+        if (run.members.size() == 1) {
+            return "sizeof(" + type + "::" + first + ")";
+        }
+        return "(offsetof(" + type + ", " + last + ") + sizeof(" + type + "::" + last + ") - offsetof(" + type + ", " +
+               first + "))";
+    }
+}
+
+void SerializationGenerator::HandleClass(FileGenerator &fileGenerator, const Class &class_) {
+    if (!class_.HasProperty(PropertyKeys::Serialize) || !FileGenerator::IsNameable(class_)) {
+        return;
+    }
+
+    const auto type = "::" + class_.fullNamespace;
+    const auto runs = FileGenerator::GetMemberRuns(class_, "Serializer");
+
+    std::string fixedSize{};
+    for (const auto &run: runs) {
+        if (!fixedSize.empty()) {
+            fixedSize += " + ";
+        }
+        if (run.isTriviallyCopyable) {
+            fixedSize += GetRunSize(type, run);
+        } else {
+            fixedSize += "GetFixedSize<decltype(" + type + "::" + run.members.front()->name + ")>()";
+        }
+    }
+
+    auto &header = FileGenerator::BeginSpecialization(GetFileName(class_), class_, "CodeGenerator/Serialization.hpp");
+    header.emplace_back("    struct Serializer<" + type + "> {");
+    header.emplace_back("        static constexpr size_t fixedSize = " + (fixedSize.empty() ? "0" : fixedSize) + ";");
+    header.emplace_back("");
+    header.emplace_back("        static void Write(Buffer &buffer, const " + type + " &object) {");
+    header.emplace_back("            buffer.Grow(fixedSize);");
+    for (const auto &run: runs) {
+        const auto &name = run.members.front()->name;
+        if (run.isTriviallyCopyable) {
+            header.emplace_back("            buffer.WriteBytes(&object." + name + ", " + GetRunSize(type, run) + ");");
+        } else if (run.members.front()->isBitField) {
+            //bit-fields have no address, they are written through a copy
+            header.emplace_back("            {");
+            header.emplace_back("                const decltype(object." + name + ") value = object." + name + ";");
+            header.emplace_back("                CodeGenerator::Write(buffer, value);");
+            header.emplace_back("            }");
+        } else {
+            header.emplace_back("            CodeGenerator::Write(buffer, object." + name + ");");
+        }
+    }
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        static bool Read(Reader &reader, " + type + " &object) {");
+    for (const auto &run: runs) {
+        const auto &name = run.members.front()->name;
+        if (run.isTriviallyCopyable) {
+            header.emplace_back("            if (!reader.ReadBytes(&object." + name + ", " + GetRunSize(type, run) +
+                                ")) {");
+            header.emplace_back("                return false;");
+            header.emplace_back("            }");
+        } else if (run.members.front()->isBitField) {
+            header.emplace_back("            {");
+            header.emplace_back("                decltype(object." + name + ") value{};");
+            header.emplace_back("                if (!CodeGenerator::Read(reader, value)) {");
+            header.emplace_back("                    return false;");
+            header.emplace_back("                }");
+            header.emplace_back("                object." + name + " = value;");
+            header.emplace_back("            }");
+        } else {
+            header.emplace_back("            if (!CodeGenerator::Read(reader, object." + name + ")) {");
+            header.emplace_back("                return false;");
+            header.emplace_back("            }");
+        }
+    }
+    header.emplace_back("            return true;");
+    header.emplace_back("        }");
+    header.emplace_back("    };");
+    header.emplace_back("}");
+    FileGenerator::EndSpecialization(header, class_);
+}
+
+std::string SerializationGenerator::GetFileName(const Object &object) {
+    return "Serialization/" + FileGenerator::GetIdentifier(object) + ".gen.hpp";
+}
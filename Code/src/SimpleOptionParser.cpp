@@ -1,6 +1,21 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <string_view>
 #include "SimpleOptionParser.hpp"
 
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace {
+    //every marker starts with CG, only the remainder has to be compared
+    constexpr std::string_view markerPrefix = "CG";
+    constexpr std::array<std::string_view, 7> markerSuffixes{
+            "CLASS", "MEMBER", "METHOD", "FUNCTION", "VARIABLE", "CONSTRUCTOR", "ENUM"
+    };
+    //both [[cg::class(...)]] and annotate("cg:class(...)") contain this
+    constexpr std::string_view annotationPrefix = "cg:";
+}
+
 SimpleOptionParser::SimpleOptionParser(const std::vector<std::string> &args,
                                        const std::vector<std::filesystem::path> &headers) : args(args),
                                                                                             headers(headers) {}
@@ -14,8 +29,7 @@ std::vector<clang::tooling::CompileCommand> SimpleOptionParser::getAllCompileCom
 
     for (const auto &header: headers) {
         //append the header to the newArgs
-        std::vector<std::string> newArgs{this->args};
-        newArgs.emplace_back(header.string());
+        auto newArgs = GetArguments(header.string());
         commands.emplace_back(header.parent_path().string(), header.filename().string(), newArgs, "");
     }
 
@@ -33,6 +47,42 @@ std::vector<std::string> SimpleOptionParser::getAllFiles() const {
     return files;
 }
 
+bool SimpleOptionParser::HasMarkers(const std::filesystem::path &file) {
+    //no null terminator is required, so llvm is free to memory map the file instead of reading it
+    auto buffer = llvm::MemoryBuffer::getFile(file.string(), false, false);
+    if (!buffer) {
+        //let clang report the error
+        return true;
+    }
+    
+    const std::string_view text{(*buffer)->getBufferStart(), (*buffer)->getBufferSize()};
+    
+    if (text.find(annotationPrefix) != std::string_view::npos) {
+        return true;
+    }
+    
+    //find uses memchr to skip to the next 'C', which is vectorized by the c library
+    for (auto position = text.find(markerPrefix); position != std::string_view::npos;
+         position = text.find(markerPrefix, position + markerPrefix.size())) {
+        const auto remainder = text.substr(position + markerPrefix.size());
+        for (const auto &suffix: markerSuffixes) {
+            if (remainder.compare(0, suffix.size(), suffix) == 0) {
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+size_t SimpleOptionParser::PruneUnannotatedHeaders() {
+    const auto size = headers.size();
+    headers.erase(std::remove_if(headers.begin(), headers.end(), [](const std::filesystem::path &header) {
+        return !HasMarkers(header);
+    }), headers.end());
+    return size - headers.size();
+}
+
 std::vector<clang::tooling::CompileCommand> SimpleOptionParser::getCompileCommands(llvm::StringRef FilePath) const {
     //create a compile command for the header and return it inside a vector
     
@@ -41,8 +91,7 @@ std::vector<clang::tooling::CompileCommand> SimpleOptionParser::getCompileComman
     //find file parent path
     std::filesystem::path file{FilePath.str()};
     
-    std::vector<std::string> newArgs{this->args};
-    newArgs.emplace_back(FilePath.str());
+    auto newArgs = GetArguments(FilePath.str());
     
     std::vector<clang::tooling::CompileCommand> commands{
             clang::tooling::CompileCommand(file.parent_path().string(), file.filename().string(), newArgs, output_directory.string() + "/" + FilePath.str())
@@ -50,6 +99,27 @@ std::vector<clang::tooling::CompileCommand> SimpleOptionParser::getCompileComman
     return commands;
 }
 
+std::vector<std::pair<std::string, std::string>> SimpleOptionParser::GetUnitySources(size_t count) const {
+    count = std::max<size_t>(1, std::min(count, headers.size()));
+    
+    std::vector<std::pair<std::string, std::string>> sources{};
+    sources.reserve(count);
+    
+    const auto directory = std::filesystem::absolute(output_directory);
+    for (size_t i = 0; i < count; ++i) {
+        //keep the header extension so clang parses the unity source the same way as a single header
+        const auto path = directory / ("CodeGenerator.unity" + std::to_string(i) + ".hpp");
+        sources.emplace_back(path.string(), "");
+    }
+    
+    //distribute the headers round-robin, the same way ToolRunner distributes files over threads
+    for (size_t i = 0; i < headers.size(); ++i) {
+        sources[i % count].second += "#include \"" + headers[i].string() + "\"\n";
+    }
+    
+    return sources;
+}
+
 void SimpleOptionParser::SetOutputDirectory(const std::filesystem::path &output_directory) {
     this->output_directory = output_directory;
 }
@@ -57,3 +127,34 @@ void SimpleOptionParser::SetOutputDirectory(const std::filesystem::path &output_
 void SimpleOptionParser::SetInputDirectory(const std::filesystem::path &input_directory) {
     this->input_directory = input_directory;
 }
+
+void SimpleOptionParser::SetHeaders(const std::vector<std::filesystem::path> &headers) {
+    this->headers = headers;
+}
+
+void SimpleOptionParser::SetPrecompiledHeader(const std::filesystem::path &precompiled_header,
+                                              std::vector<std::string> inputs) {
+    this->precompiled_header = precompiled_header;
+    this->precompiled_header_inputs = std::move(inputs);
+}
+
+const std::filesystem::path &SimpleOptionParser::GetPrecompiledHeader() const {
+    return precompiled_header;
+}
+
+const std::vector<std::string> &SimpleOptionParser::GetPrecompiledHeaderInputs() const {
+    return precompiled_header_inputs;
+}
+
+std::vector<std::string> SimpleOptionParser::GetArguments(const std::string &file) const {
+    std::vector<std::string> newArgs{this->args};
+    
+    //the precompiled header is implicitly included before the first line of the file
+    if (!precompiled_header.empty()) {
+        newArgs.emplace_back("-include-pch");
+        newArgs.emplace_back(precompiled_header.string());
+    }
+    
+    newArgs.emplace_back(file);
+    return newArgs;
+}
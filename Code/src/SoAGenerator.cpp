@@ -0,0 +1,234 @@
+#include "SoAGenerator.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    //names the specialization declares itself, a column with one of these names would collide with them
+    const std::vector<std::string> reservedNames{
+            "value_type", "Reference", "ConstReference", "Iterator", "ConstIterator",
+            "Size", "IsEmpty", "Reserve", "PushBack", "Erase", "Clear", "begin", "end"
+    };
+
+    //a name for a generated parameter or local that no column has, so it never shadows a column
+    std::string GetUnusedName(const std::vector<Variable> &columns, std::string name) {
+        while (std::any_of(columns.begin(), columns.end(), [&name](const auto &variable) {
+            return variable.name == name;
+        })) {
+            name += '_';
+        }
+        return name;
+    }
+
+    //the members of a proxy reference, and the expressions that initialize them from the columns
+    void WriteReference(std::vector<std::string> &header, const std::vector<Variable> &columns, const std::string &type,
+                        const std::string &name, const std::string &qualifier) {
+        const auto object = GetUnusedName(columns, "object");
+        const auto other = GetUnusedName(columns, "other");
+
+        header.emplace_back("        struct " + name + " {");
+        std::string parameters{};
+        std::string initializers{};
+        for (const auto &variable: columns) {
+            const auto member = qualifier + "decltype(" + type + "::" + variable.name + ") &" + variable.name;
+            header.emplace_back("            " + member + ";");
+            parameters += (parameters.empty() ? "" : ", ") + member;
+            initializers += (initializers.empty() ? "" : ", ") + variable.name + "(" + variable.name + ")";
+        }
+        header.emplace_back("");
+        //a constructor instead of aggregate initialization, the copy assignment below makes this no aggregate in C++20
+        header.emplace_back("            " + name + "(" + parameters + ") : " + initializers + " {}");
+        header.emplace_back("");
+        header.emplace_back("            " + name + "(const " + name + " &) = default;");
+        header.emplace_back("");
+        //members that aren't annotated keep the value they are default initialized with
+        header.emplace_back("            operator " + type + "() const {");
+        header.emplace_back("                " + type + " " + object + "{};");
+        for (const auto &variable: columns) {
+            header.emplace_back("                " + object + "." + variable.name + " = this->" + variable.name + ";");
+        }
+        header.emplace_back("                return " + object + ";");
+        header.emplace_back("            }");
+        if (qualifier.empty()) {
+            header.emplace_back("");
+            header.emplace_back("            const " + name + " &operator=(const " + type + " &" + object +
+                                ") const {");
+            for (const auto &variable: columns) {
+                header.emplace_back("                this->" + variable.name + " = " + object + "." + variable.name +
+                                    ";");
+            }
+            header.emplace_back("                return *this;");
+            header.emplace_back("            }");
+            header.emplace_back("");
+            //assigning a proxy to a proxy copies the values, so algorithms like std::sort move the elements
+            header.emplace_back("            const " + name + " &operator=(const " + name + " &" + other + ") const {");
+            for (const auto &variable: columns) {
+                header.emplace_back("                this->" + variable.name + " = " + other + "." + variable.name +
+                                    ";");
+            }
+            header.emplace_back("                return *this;");
+            header.emplace_back("            }");
+            header.emplace_back("");
+            header.emplace_back("            friend void swap(const " + name + " &a, const " + name + " &b) {");
+            header.emplace_back("                using std::swap;");
+            for (const auto &variable: columns) {
+                header.emplace_back("                swap(a." + variable.name + ", b." + variable.name + ");");
+            }
+            header.emplace_back("            }");
+        }
+        header.emplace_back("        };");
+    }
+
+    //a call of the method on every column, the columns always have the same size
+    void WriteForEachColumn(std::vector<std::string> &header, const std::vector<Variable> &columns,
+                            const std::string &call) {
+        for (const auto &variable: columns) {
+            header.emplace_back("            this->" + variable.name + "." + call + ";");
+        }
+    }
+
+    //the initializer of a proxy reference to the element at index
+    std::string GetReferenceInitializer(const std::vector<Variable> &columns, const std::string &index) {
+        std::string initializer{};
+        for (const auto &variable: columns) {
+            if (!initializer.empty()) {
+                initializer += ", ";
+            }
+            initializer += "this->" + variable.name + "[" + index + "]";
+        }
+        return "{" + initializer + "}";
+    }
+}
+
+void SoAGenerator::HandleClass(FileGenerator &fileGenerator, const Class &class_) {
+    if (!class_.HasProperty(PropertyKeys::SoA) || !FileGenerator::IsNameable(class_)) {
+        return;
+    }
+
+    //arrays can't be constructed from an array in a column, the member keeps its default value instead
+    std::vector<Variable> columns{};
+    for (const auto &variable: class_.variables) {
+        if (!FileGenerator::IsAccessible(class_, variable, "SoA container")) {
+            continue;
+        }
+        if (variable.isArray) {
+            std::cerr << "Warning: " << class_.fullNamespace << "::" << variable.name
+                      << " is an array, it has no column in the SoA container" << std::endl;
+            continue;
+        }
+        //a column holds values, and Erase moves the elements after the erased one forward
+        if (variable.isReference || variable.isConst) {
+            std::cerr << "Warning: " << class_.fullNamespace << "::" << variable.name << " is a "
+                      << (variable.isReference ? "reference" : "const member")
+                      << ", it has no column in the SoA container" << std::endl;
+            continue;
+        }
+        if (std::find(reservedNames.begin(), reservedNames.end(), variable.name) != reservedNames.end()) {
+            std::cerr << "Warning: " << class_.fullNamespace << "::" << variable.name
+                      << " has the name of a member of the SoA container, it has no column" << std::endl;
+            continue;
+        }
+        columns.emplace_back(variable);
+    }
+    if (columns.empty()) {
+        return;
+    }
+
+    const auto type = "::" + class_.fullNamespace;
+    const auto &first = columns.front().name;
+
+    //the columns are named like the members, so the columns are accessed through this-> and the generated
+    //parameters and locals get names no column has
+    const auto capacity = GetUnusedName(columns, "capacity");
+    const auto object = GetUnusedName(columns, "object");
+    const auto size = GetUnusedName(columns, "size");
+    const auto index = GetUnusedName(columns, "index");
+    const auto position = GetUnusedName(columns, "position");
+
+    auto &header = FileGenerator::BeginSpecialization(GetFileName(class_), class_, "CodeGenerator/SoA.hpp");
+    header.emplace_back("    class SoA<" + type + "> {");
+    header.emplace_back("    public:");
+    header.emplace_back("        using value_type = " + type + ";");
+    header.emplace_back("");
+    for (const auto &variable: columns) {
+        header.emplace_back("        Column<decltype(" + type + "::" + variable.name + ")> " + variable.name + ";");
+    }
+    header.emplace_back("");
+    WriteReference(header, columns, type, "Reference", "");
+    header.emplace_back("");
+    WriteReference(header, columns, type, "ConstReference", "const ");
+    header.emplace_back("");
+    header.emplace_back("        using Iterator = SoAIterator<SoA, Reference>;");
+    header.emplace_back("        using ConstIterator = SoAIterator<const SoA, ConstReference>;");
+    header.emplace_back("");
+    header.emplace_back("        [[nodiscard]] size_t Size() const {");
+    header.emplace_back("            return this->" + first + ".Size();");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        [[nodiscard]] bool IsEmpty() const {");
+    header.emplace_back("            return this->" + first + ".Size() == 0;");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        void Reserve(size_t " + capacity + ") {");
+    WriteForEachColumn(header, columns, "Reserve(" + capacity + ")");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    //if copying a member throws, the members copied before it are removed again, so the columns keep the same size
+    header.emplace_back("        void PushBack(const value_type &" + object + ") {");
+    header.emplace_back("            const auto " + size + " = Size();");
+    header.emplace_back("            try {");
+    for (const auto &variable: columns) {
+        header.emplace_back("                this->" + variable.name + ".EmplaceBack(" + object + "." + variable.name +
+                            ");");
+    }
+    header.emplace_back("            } catch (...) {");
+    for (const auto &variable: columns) {
+        header.emplace_back("                this->" + variable.name + ".Truncate(" + size + ");");
+    }
+    header.emplace_back("                throw;");
+    header.emplace_back("            }");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        void Erase(size_t " + index + ") {");
+    WriteForEachColumn(header, columns, "Erase(" + index + ")");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        void Erase(Iterator " + position + ") {");
+    header.emplace_back("            Erase(" + position + ".GetIndex());");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        void Clear() {");
+    WriteForEachColumn(header, columns, "Clear()");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        Reference operator[](size_t " + index + ") {");
+    header.emplace_back("            return " + GetReferenceInitializer(columns, index) + ";");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        ConstReference operator[](size_t " + index + ") const {");
+    header.emplace_back("            return " + GetReferenceInitializer(columns, index) + ";");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        Iterator begin() {");
+    header.emplace_back("            return {this, 0};");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        Iterator end() {");
+    header.emplace_back("            return {this, Size()};");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        ConstIterator begin() const {");
+    header.emplace_back("            return {this, 0};");
+    header.emplace_back("        }");
+    header.emplace_back("");
+    header.emplace_back("        ConstIterator end() const {");
+    header.emplace_back("            return {this, Size()};");
+    header.emplace_back("        }");
+    header.emplace_back("    };");
+    header.emplace_back("}");
+    FileGenerator::EndSpecialization(header, class_);
+}
+
+std::string SoAGenerator::GetFileName(const Object &object) {
+    return "SoA/" + FileGenerator::GetIdentifier(object) + ".gen.hpp";
+}
@@ -0,0 +1,159 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+std::mutex Statistics::mutex{};
+std::array<Statistics::Duration, static_cast<size_t>(Statistics::Phase::Count)> Statistics::phases{};
+Statistics::Counters Statistics::counters{};
+std::vector<Statistics::FileTiming> Statistics::files{};
+
+namespace {
+    constexpr std::array<const char *, static_cast<size_t>(Statistics::Phase::Count)> phaseNames{
+            "loadProject", "parse", "traverse", "generate", "write", "total"
+    };
+
+    //amount of files listed in the table, the JSON output contains all files
+    constexpr size_t slowestFileCount = 10;
+
+    double ToMilliseconds(Statistics::Duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    //paths on windows contain backslashes, which have to be escaped in JSON
+    std::string EscapeJson(const std::string &text) {
+        std::string result{};
+        result.reserve(text.size());
+
+        for (const char c: text) {
+            switch (c) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                default:
+                    result += c;
+            }
+        }
+
+        return result;
+    }
+}
+
+void Statistics::AddTime(Phase phase, Duration duration) {
+    std::lock_guard lock{mutex};
+    phases[static_cast<size_t>(phase)] += duration;
+}
+
+void Statistics::AddFile(const std::string &file, Duration parse, Duration traverse) {
+    std::lock_guard lock{mutex};
+    phases[static_cast<size_t>(Phase::Parse)] += parse;
+    phases[static_cast<size_t>(Phase::Traverse)] += traverse;
+    files.push_back({file, parse, traverse});
+}
+
+void Statistics::AddCounters(const Counters &added) {
+    std::lock_guard lock{mutex};
+    counters.declsVisited += added.declsVisited;
+    counters.declsSkipped += added.declsSkipped;
+    counters.declsSkippedByFileID += added.declsSkippedByFileID;
+    counters.annotatedEntities += added.annotatedEntities;
+    counters.skippedParameters += added.skippedParameters;
+}
+
+Statistics::Duration Statistics::GetTime(Phase phase) {
+    std::lock_guard lock{mutex};
+    return phases[static_cast<size_t>(phase)];
+}
+
+Statistics::Counters Statistics::GetCounters() {
+    std::lock_guard lock{mutex};
+    return counters;
+}
+
+void Statistics::Reset() {
+    std::lock_guard lock{mutex};
+    phases.fill(Duration::zero());
+    counters = {};
+    files.clear();
+}
+
+void Statistics::PrintTable(std::ostream &output) {
+    std::lock_guard lock{mutex};
+
+    const auto flags = output.flags();
+    output << std::fixed << std::setprecision(2);
+
+    output << "Phase                 Time (ms)" << std::endl;
+    for (size_t i = 0; i < phases.size(); ++i) {
+        output << std::left << std::setw(20) << phaseNames[i] << std::right << std::setw(12)
+               << ToMilliseconds(phases[i]) << std::endl;
+    }
+    output << std::endl;
+
+    output << "Counter                   Value" << std::endl;
+    output << std::left << std::setw(20) << "declsVisited" << std::right << std::setw(12) << counters.declsVisited << std::endl;
+    output << std::left << std::setw(20) << "declsSkipped" << std::right << std::setw(12) << counters.declsSkipped << std::endl;
+    output << std::left << std::setw(20) << "declsSkippedByFileID" << std::right << std::setw(12) << counters.declsSkippedByFileID << std::endl;
+    output << std::left << std::setw(20) << "annotatedEntities" << std::right << std::setw(12) << counters.annotatedEntities << std::endl;
+    output << std::left << std::setw(20) << "skippedParameters" << std::right << std::setw(12) << counters.skippedParameters << std::endl;
+    output << std::left << std::setw(20) << "files" << std::right << std::setw(12) << files.size() << std::endl;
+    output << std::endl;
+
+    //only list the slowest files, a project can easily contain thousands of headers
+    std::vector<const FileTiming *> slowest{};
+    slowest.reserve(files.size());
+    for (const auto &file: files) {
+        slowest.emplace_back(&file);
+    }
+
+    const auto count = std::min(slowestFileCount, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + static_cast<std::ptrdiff_t>(count), slowest.end(),
+                      [](const FileTiming *a, const FileTiming *b) {
+                          return a->parse + a->traverse > b->parse + b->traverse;
+                      });
+
+    if (count > 0) {
+        output << "Slowest files    Parse (ms)  Traverse (ms)" << std::endl;
+        for (size_t i = 0; i < count; ++i) {
+            output << std::setw(26) << ToMilliseconds(slowest[i]->parse) << std::setw(15)
+                   << ToMilliseconds(slowest[i]->traverse) << "  " << slowest[i]->file << std::endl;
+        }
+    }
+
+    output.flags(flags);
+}
+
+void Statistics::WriteJson(std::ostream &output) {
+    std::lock_guard lock{mutex};
+
+    output << "{\n  \"phases\": {";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        output << (i == 0 ? "\n" : ",\n") << "    \"" << phaseNames[i] << "\": " << ToMilliseconds(phases[i]);
+    }
+    output << "\n  },\n";
+
+    output << "  \"counters\": {\n"
+           << "    \"declsVisited\": " << counters.declsVisited << ",\n"
+           << "    \"declsSkipped\": " << counters.declsSkipped << ",\n"
+           << "    \"declsSkippedByFileID\": " << counters.declsSkippedByFileID << ",\n"
+           << "    \"annotatedEntities\": " << counters.annotatedEntities << ",\n"
+           << "    \"skippedParameters\": " << counters.skippedParameters << "\n"
+           << "  },\n";
+
+    output << "  \"files\": [";
+    for (size_t i = 0; i < files.size(); ++i) {
+        output << (i == 0 ? "\n" : ",\n") << "    {\"file\": \"" << EscapeJson(files[i].file)
+               << "\", \"parse\": " << ToMilliseconds(files[i].parse)
+               << ", \"traverse\": " << ToMilliseconds(files[i].traverse) << "}";
+    }
+    output << "\n  ]\n}" << std::endl;
+}
@@ -0,0 +1,240 @@
+#include "ToolRunner.hpp"
+#include "FileParser.hpp"
+
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/FrontendActions.h>
+#include <clang/Tooling/Tooling.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/VirtualFileSystem.h>
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+    /// \brief generates a precompiled header at a fixed path, the tooling argument adjusters strip any -o argument
+    class PrecompiledHeaderAction : public clang::GeneratePCHAction {
+        std::string output;
+        std::vector<std::string> &inputs;
+    public:
+        PrecompiledHeaderAction(std::string output, std::vector<std::string> &inputs) :
+            output(std::move(output)), inputs(inputs) {}
+    
+    protected:
+        bool BeginInvocation(clang::CompilerInstance &compilerInstance) override {
+            compilerInstance.getFrontendOpts().OutputFile = output;
+            return clang::GeneratePCHAction::BeginInvocation(compilerInstance);
+        }
+        
+        //every file of the precompiled header is a local entry while it is built, later they are loaded entries
+        void EndSourceFileAction() override {
+            const auto &sourceManager = getCompilerInstance().getSourceManager();
+            for (unsigned i = 1; i < sourceManager.local_sloc_entry_size(); ++i) {
+                const auto &entry = sourceManager.getLocalSLocEntry(i);
+                if (!entry.isFile()) {
+                    continue;
+                }
+                
+                //<built-in> and <command line> are not files
+                const auto name = entry.getFile().getName();
+                if (name.empty() || name.starts_with("<")) {
+                    continue;
+                }
+                inputs.emplace_back(ASTFileParser::NormalizePath(name.str()));
+            }
+            
+            std::sort(inputs.begin(), inputs.end());
+            inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+            
+            clang::GeneratePCHAction::EndSourceFileAction();
+        }
+    };
+    
+    class PrecompiledHeaderActionFactory : public clang::tooling::FrontendActionFactory {
+        std::string output;
+        std::vector<std::string> &inputs;
+    public:
+        PrecompiledHeaderActionFactory(std::string output, std::vector<std::string> &inputs) :
+            output(std::move(output)), inputs(inputs) {}
+        
+        std::unique_ptr<clang::FrontendAction> create() override {
+            return std::make_unique<PrecompiledHeaderAction>(output, inputs);
+        }
+    };
+    
+    /// \brief status results that are shared between all tools and runs, see ToolRunner::EnableStatCache
+    struct StatCache {
+        bool enabled = false;
+        std::vector<std::string> volatileDirectories;
+        
+        std::mutex mutex;
+        //std::nullopt means the file does not exist
+        llvm::StringMap<std::optional<llvm::vfs::Status>> entries;
+        
+        bool IsVolatile(llvm::StringRef path) const {
+            //whole path components are compared, /x/src must not match /x/src2
+            return std::any_of(volatileDirectories.begin(), volatileDirectories.end(), [&path](const auto &directory) {
+                if (!path.starts_with(directory)) {
+                    return false;
+                }
+                return path.size() == directory.size() || llvm::sys::path::is_separator(directory.back()) ||
+                       llvm::sys::path::is_separator(path[directory.size()]);
+            });
+        }
+    } statCache{};
+    
+    /// \brief caches the status of absolute paths outside the volatile directories
+    /// \note header search stats every include directory for every #include, most of those lookups are misses
+    class StatCachingFileSystem : public llvm::vfs::ProxyFileSystem {
+    public:
+        explicit StatCachingFileSystem(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fileSystem)
+                : ProxyFileSystem(std::move(fileSystem)) {}
+        
+        llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine &path) override {
+            llvm::SmallString<256> normalized{};
+            path.toVector(normalized);
+            
+            //relative paths depend on the working directory of the tool, those can't be shared
+            if (!llvm::sys::path::is_absolute(normalized)) {
+                return ProxyFileSystem::status(path);
+            }
+            
+            llvm::sys::path::remove_dots(normalized, true);
+            llvm::sys::path::native(normalized);
+            if (statCache.IsVolatile(normalized)) {
+                return ProxyFileSystem::status(path);
+            }
+            
+            {
+                std::lock_guard lock{statCache.mutex};
+                const auto it = statCache.entries.find(normalized);
+                if (it != statCache.entries.end()) {
+                    if (it->second.has_value()) {
+                        return *it->second;
+                    }
+                    return std::make_error_code(std::errc::no_such_file_or_directory);
+                }
+            }
+            
+            auto result = ProxyFileSystem::status(path);
+            
+            //only existing files and missing files are cached, other errors may be temporary
+            std::lock_guard lock{statCache.mutex};
+            if (result) {
+                statCache.entries.try_emplace(normalized, *result);
+            } else if (result.getError() == std::errc::no_such_file_or_directory) {
+                statCache.entries.try_emplace(normalized, std::nullopt);
+            }
+            
+            return result;
+        }
+    };
+    
+    /// \brief creates the file system for a tool
+    /// \param isolated true to give the tool its own working directory, required when tools run on multiple threads
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> CreateFileSystem(bool isolated) {
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fileSystem{};
+        if (isolated) {
+            fileSystem = llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>{llvm::vfs::createPhysicalFileSystem().release()};
+        } else {
+            fileSystem = llvm::vfs::getRealFileSystem();
+        }
+        
+        if (statCache.enabled) {
+            fileSystem = llvm::makeIntrusiveRefCnt<StatCachingFileSystem>(std::move(fileSystem));
+        }
+        
+        return fileSystem;
+    }
+}
+
+void ToolRunner::EnableStatCache(const std::vector<std::filesystem::path> &volatileDirectories) {
+    std::lock_guard lock{statCache.mutex};
+    statCache.enabled = true;
+    statCache.entries.clear();
+    statCache.volatileDirectories.clear();
+    
+    for (const auto &directory: volatileDirectories) {
+        llvm::SmallString<256> normalized{ASTFileParser::NormalizePath(directory)};
+        llvm::sys::path::native(normalized);
+        statCache.volatileDirectories.emplace_back(normalized.str());
+    }
+}
+
+unsigned ToolRunner::GetJobCount(unsigned jobs) {
+    if (jobs == 0) {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+    return jobs;
+}
+
+int ToolRunner::Run(const clang::tooling::CompilationDatabase &database, const std::vector<std::string> &files,
+                    unsigned jobs, const std::vector<std::pair<std::string, std::string>> &virtualFiles) {
+    jobs = std::min<unsigned>(GetJobCount(jobs), std::max<size_t>(files.size(), 1));
+
+    //reserve space for the FileParser
+    ASTFileParser::Reserve(files.size());
+
+    int result = 0;
+
+    if (jobs == 1) {
+        clang::tooling::ClangTool tool{database, files, std::make_shared<clang::PCHContainerOperations>(),
+                                       CreateFileSystem(false)};
+        for (const auto &[path, content]: virtualFiles) {
+            tool.mapVirtualFile(path, content);
+        }
+        result = tool.run(clang::tooling::newFrontendActionFactory<ASTFrontendAction>().get());
+    } else {
+        std::cout << "Parsing " << files.size() << " files using " << jobs << " threads" << std::endl;
+
+        //distribute the files round-robin so large and small headers are spread evenly over the threads
+        std::vector<std::vector<std::string>> chunks(jobs);
+        for (size_t i = 0; i < files.size(); ++i) {
+            chunks[i % jobs].emplace_back(files[i]);
+        }
+
+        std::vector<int> results(jobs, 0);
+        std::vector<std::thread> threads{};
+        threads.reserve(jobs);
+
+        for (unsigned i = 0; i < jobs; ++i) {
+            threads.emplace_back([&database, &chunks, &results, &virtualFiles, i]() {
+                //the real file system changes the working directory of the whole process,
+                //each thread gets its own physical file system so the tools don't interfere with each other
+                clang::tooling::ClangTool tool{database, chunks[i],
+                                               std::make_shared<clang::PCHContainerOperations>(),
+                                               CreateFileSystem(true)};
+                for (const auto &[path, content]: virtualFiles) {
+                    tool.mapVirtualFile(path, content);
+                }
+                results[i] = tool.run(clang::tooling::newFrontendActionFactory<ASTFrontendAction>().get());
+            });
+        }
+
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        result = *std::max_element(results.begin(), results.end());
+    }
+
+    //threads finish in an arbitrary order, sort the parsers so the generated output is deterministic
+    ASTFileParser::SortParsers(files);
+
+    return result;
+}
+
+int ToolRunner::BuildPrecompiledHeader(const clang::tooling::CompilationDatabase &database,
+                                       const std::filesystem::path &prelude, const std::filesystem::path &output,
+                                       std::vector<std::string> &inputs) {
+    std::cout << "Precompiling prelude: " << prelude.string() << std::endl;
+
+    inputs.clear();
+    clang::tooling::ClangTool tool{database, {std::filesystem::absolute(prelude).string()}};
+    PrecompiledHeaderActionFactory factory{std::filesystem::absolute(output).string(), inputs};
+
+    return tool.run(&factory);
+}